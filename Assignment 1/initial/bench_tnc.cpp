@@ -0,0 +1,435 @@
+/*
+ * Micro-benchmarks for the functions of tay_nguyen_campaign.h.
+ *
+ * Usage: bench_tnc [--seed N] [--reps N] [--filter TEXT]
+ *
+ * Every benchmark draws its inputs from a seeded generator, so two runs with
+ * the same seed time the same work. Each one runs WARMUP_REPS untimed
+ * repetitions, then --reps timed repetitions of a fixed number of calls.
+ * Each repetition gives one ns/op sample; the samples are reported as
+ * mean, min and percentiles.
+ *
+ * Output is tab-separated, one line per benchmark after a header line:
+ *   bench  items  reps  mean_ns  min_ns  p50_ns  p90_ns  p99_ns  max_ns
+ * where ns are per item (one call, or one record of a batch call). Lines
+ * starting with '#' carry the run settings and the result checks of the
+ * baseline benchmarks. `sort | diff` two outputs or load them into any
+ * spreadsheet to compare builds.
+ *
+ * Benchmarks named "(baseline)" time the original assignment code that a
+ * rewrite replaced, on the same inputs as the rewrite.
+ */
+
+#include "tay_nguyen_campaign.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+const int WARMUP_REPS = 3;
+const int POOL = 1024;         // distinct inputs per benchmark, cycled through
+const int BATCH_RECORDS = 4096; // records per call of the batch benchmarks
+
+// xorshift64*: small, fast and the same on every platform
+struct Rng {
+  unsigned long long s;
+  explicit Rng(unsigned long long seed) : s(seed * 2685821657736338717ULL + 1) {}
+  unsigned long long next() {
+    s ^= s >> 12; s ^= s << 25; s ^= s >> 27;
+    return s * 2685821657736338717ULL;
+  }
+  // Uniform in [lo, hi]
+  int range(int lo, int hi) {
+    return lo + (int)(next() % (unsigned long long)(hi - lo + 1));
+  }
+};
+
+struct Options {
+  unsigned long long seed;
+  int reps;
+  const char *filter;
+};
+
+volatile long long sink; // keeps results alive so calls are not optimised away
+
+int compareDouble(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x < y) ? -1 : (x > y);
+}
+
+// Nearest-rank percentile of sorted samples
+double percentile(const double sorted[], int n, int pct) {
+  int rank = (pct * n + 99) / 100;
+  if (rank < 1) rank = 1;
+  return sorted[rank - 1];
+}
+
+// Times `calls` calls of op(i) per repetition; every call handles `items`
+// items. op returns a value folded into the sink.
+template<class Op>
+void runBench(const Options &opt, const char *name, int calls, int items, Op op) {
+  if (opt.filter != nullptr && strstr(name, opt.filter) == nullptr) return;
+
+  long long acc = 0;
+  for (int r = 0; r < WARMUP_REPS; r++) {
+    for (int i = 0; i < calls; i++) acc += op(i);
+  }
+
+  double *samples = new double[opt.reps];
+  for (int r = 0; r < opt.reps; r++) {
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    for (int i = 0; i < calls; i++) acc += op(i);
+    chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+    samples[r] = chrono::duration<double, nano>(t1 - t0).count() / ((double)calls * items);
+  }
+  sink = sink + acc;
+
+  double mean = 0;
+  for (int r = 0; r < opt.reps; r++) mean += samples[r];
+  mean /= opt.reps;
+  qsort(samples, opt.reps, sizeof(double), compareDouble);
+  printf("%s\t%d\t%d\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\n", name, items, opt.reps, mean,
+         samples[0], percentile(samples, opt.reps, 50), percentile(samples, opt.reps, 90),
+         percentile(samples, opt.reps, 99), samples[opt.reps - 1]);
+  fflush(stdout);
+  delete[] samples;
+}
+
+// The original decodeTarget and its helpers, as first written for the
+// assignment (validTargets[i] is targetName(3 + i))
+namespace baseline {
+
+string tolowerCase(const string &s) {
+  string result = s;
+  for (char &c : result) {
+    if (c >= 'A' && c <= 'Z') {
+      c = tolower(c);
+    }
+  }
+  return result;
+}
+
+string caesarCipherDecode(const string &message, int shift) {
+  string decoded;
+  for (char c : message) {
+    if (!isalnum(c) && c != ' ') return "INVALID";
+    if (isalpha(c)) {
+      char base = islower(c) ? 'a' : 'A';
+      decoded += (c - base + shift) % 26 + base;
+    } else {
+      decoded += c;
+    }
+  }
+  return decoded;
+}
+
+string reverseString(string message) {
+  for (char c : message) {
+    if (!isalnum(c) && c != ' ') {
+      return "INVALID";
+    }
+  }
+  int left = 0, right = message.length() - 1;
+  while (left < right) {
+    char temp = message[left];
+    message[left] = message[right];
+    message[right] = temp;
+    left++;
+    right--;
+  }
+  return message;
+}
+
+string decodeTarget(const string &message, int EXP1, int EXP2) {
+  EXP1 = min(max(EXP1, 0), 600); EXP2 = min(max(EXP2, 0), 600);
+  string decodedMessage;
+  if (EXP1 >= 300 && EXP2 >= 300) {
+    int shift = (EXP1 + EXP2) % 26;
+    decodedMessage = caesarCipherDecode(message, shift);
+  } else {
+    decodedMessage = reverseString(message);
+  }
+  for (int i = 0; i < 5; i++) {
+    if (tolowerCase(decodedMessage) == tolowerCase(targetName(3 + i))) return targetName(3 + i);
+  }
+  return "INVALID";
+}
+
+} // namespace baseline
+
+// Input generators. Each takes its own Rng so that adding a benchmark does
+// not shift the inputs of the others.
+
+void genLF(Rng &rng, int LF[17]) {
+  for (int i = 0; i < 17; i++) LF[i] = rng.range(-20, 1050); // a few out of range
+}
+
+// A target message: text with 0-4 numbers mixed in
+string genMessage(Rng &rng) {
+  static const char *words[] = {"Buon", "Ma", "Thuot", "Duc", "Lap", "Kon", "Tum", "Pleiku"};
+  string msg;
+  int parts = rng.range(2, 6), numbers = rng.range(0, 4);
+  for (int i = 0; i < parts + numbers; i++) {
+    if (i > 0) msg += ' ';
+    if (rng.range(0, parts + numbers - 1) < numbers) {
+      msg += to_string(rng.range(0, 120));
+    } else {
+      msg += words[rng.range(0, 7)];
+    }
+  }
+  return msg;
+}
+
+// A coded message: a target name, Caesar-shifted or reversed, sometimes
+// corrupted, with EXP1/EXP2 drawn to match either coding
+string genCoded(Rng &rng, int &EXP1, int &EXP2) {
+  string msg = targetName(rng.range(3, 7));
+  EXP1 = rng.range(0, 600);
+  EXP2 = rng.range(0, 600);
+  if (EXP1 >= 300 && EXP2 >= 300) {
+    int shift = (EXP1 + EXP2) % 26;
+    for (size_t i = 0; i < msg.size(); i++) {
+      char c = msg[i];
+      if (c >= 'a' && c <= 'z') msg[i] = 'a' + (c - 'a' + shift) % 26;
+      else if (c >= 'A' && c <= 'Z') msg[i] = 'A' + (c - 'A' + shift) % 26;
+    }
+  } else {
+    msg = string(msg.rbegin(), msg.rend());
+  }
+  if (rng.range(0, 9) == 0) msg[rng.range(0, (int)msg.size() - 1)] = '#';
+  for (size_t i = 0; i < msg.size(); i++) {
+    if (rng.range(0, 3) == 0 && msg[i] >= 'a' && msg[i] <= 'z') msg[i] -= 'a' - 'A';
+  }
+  return msg;
+}
+
+struct LogisticsInput {
+  int LF1, LF2, EXP1, EXP2, T1, T2, E;
+};
+
+void genLogistics(Rng &rng, LogisticsInput &in) {
+  in.LF1 = rng.range(0, 1000); in.LF2 = rng.range(0, 1000);
+  in.EXP1 = rng.range(0, 600); in.EXP2 = rng.range(0, 600);
+  in.T1 = rng.range(0, 3000); in.T2 = rng.range(0, 3000);
+  in.E = rng.range(0, 110); // a few outside 0..99
+}
+
+void genField(Rng &rng, int field[10][10]) {
+  for (int i = 0; i < 10; i++)
+    for (int j = 0; j < 10; j++) field[i][j] = rng.range(0, 700);
+}
+
+void genSupply(Rng &rng, int supply[5][5], int &shortfall) {
+  for (int i = 0; i < 5; i++)
+    for (int j = 0; j < 5; j++) supply[i][j] = rng.range(0, 700);
+  shortfall = rng.range(0, 3500);
+}
+
+// One readFile-format scenario of five lines
+string genScenarioText(Rng &rng) {
+  string text;
+  for (int side = 0; side < 2; side++) {
+    text += '[';
+    for (int i = 0; i < 17; i++) {
+      if (i > 0) text += ',';
+      text += to_string(rng.range(0, 1000));
+    }
+    text += "]\n";
+  }
+  text += to_string(rng.range(0, 600)) + ' ' + to_string(rng.range(0, 600)) + '\n';
+  text += to_string(rng.range(0, 3000)) + ' ' + to_string(rng.range(0, 3000)) + '\n';
+  text += to_string(rng.range(0, 99)) + '\n';
+  return text;
+}
+
+void benchForces(const Options &opt) {
+  Rng rng(opt.seed ^ 1);
+  static int LF1[POOL][17], LF2[POOL][17];
+  for (int i = 0; i < POOL; i++) { genLF(rng, LF1[i]); genLF(rng, LF2[i]); }
+  runBench(opt, "gatherForces", POOL, 1, [&](int i) {
+    int a[17], b[17];
+    memcpy(a, LF1[i], sizeof(a)); memcpy(b, LF2[i], sizeof(b));
+    return (long long)gatherForces(a, b);
+  });
+
+  // Column-major copies for the batch version
+  int *col1 = new int[17 * BATCH_RECORDS], *col2 = new int[17 * BATCH_RECORDS];
+  int *result = new int[BATCH_RECORDS];
+  for (int r = 0; r < BATCH_RECORDS; r++)
+    for (int i = 0; i < 17; i++) {
+      col1[i * BATCH_RECORDS + r] = LF1[r % POOL][i];
+      col2[i * BATCH_RECORDS + r] = LF2[r % POOL][i];
+    }
+  runBench(opt, "gatherForcesBatch", 16, BATCH_RECORDS, [&](int i) {
+    gatherForcesBatch(col1, col2, BATCH_RECORDS, result);
+    return (long long)result[i];
+  });
+  delete[] col1; delete[] col2; delete[] result;
+}
+
+void benchTargets(const Options &opt) {
+  Rng rng(opt.seed ^ 2);
+  static string messages[POOL];
+  string all;
+  for (int i = 0; i < POOL; i++) {
+    messages[i] = genMessage(rng);
+    all += messages[i] + '\n';
+  }
+  runBench(opt, "determineRightTarget", POOL, 1, [&](int i) {
+    return (long long)determineRightTarget(messages[i]).size();
+  });
+  runBench(opt, "determineRightTargetId", POOL, 1, [&](int i) {
+    return (long long)determineRightTargetId(messages[i].data(), messages[i].size());
+  });
+  runBench(opt, "determineRightTargets", 4, POOL, [&](int) {
+    ostringstream out;
+    return determineRightTargets(all.data(), all.size(), out);
+  });
+
+  static string coded[POOL];
+  static int exp1[POOL], exp2[POOL];
+  for (int i = 0; i < POOL; i++) coded[i] = genCoded(rng, exp1[i], exp2[i]);
+  runBench(opt, "decodeTarget", POOL, 1, [&](int i) {
+    return (long long)decodeTarget(coded[i], exp1[i], exp2[i]).size();
+  });
+  if (opt.filter == nullptr || strstr("decodeTarget (baseline)", opt.filter) != nullptr) {
+    int differ = 0;
+    for (int i = 0; i < POOL; i++) {
+      differ += baseline::decodeTarget(coded[i], exp1[i], exp2[i]) != decodeTarget(coded[i], exp1[i], exp2[i]);
+    }
+    printf("# decodeTarget (baseline): %d of %d results differ\n", differ, POOL);
+  }
+  runBench(opt, "decodeTarget (baseline)", POOL, 1, [&](int i) {
+    return (long long)baseline::decodeTarget(coded[i], exp1[i], exp2[i]).size();
+  });
+  runBench(opt, "decodeTargetId", POOL, 1, [&](int i) {
+    return (long long)decodeTargetId(coded[i].data(), coded[i].size(), exp1[i], exp2[i]);
+  });
+  runBench(opt, "searchTargets", POOL, 1, [&](int i) {
+    int target[MAX_TARGET_MATCHES], shift[MAX_TARGET_MATCHES];
+    return (long long)searchTargets(coded[i].data(), coded[i].size(), target, shift);
+  });
+
+  // Every message recurs, so after the warmup all lookups hit
+  DecodeCache cache(4 * POOL, 16);
+  runBench(opt, "DecodeCache::determineRightTargetId", POOL, 1, [&](int i) {
+    return (long long)cache.determineRightTargetId(messages[i].data(), messages[i].size());
+  });
+  runBench(opt, "DecodeCache::decodeTargetId", POOL, 1, [&](int i) {
+    return (long long)cache.decodeTargetId(coded[i].data(), coded[i].size(), exp1[i], exp2[i]);
+  });
+}
+
+void benchLogistics(const Options &opt) {
+  Rng rng(opt.seed ^ 3);
+  static LogisticsInput in[POOL];
+  for (int i = 0; i < POOL; i++) genLogistics(rng, in[i]);
+  runBench(opt, "manageLogistics", POOL, 1, [&](int i) {
+    int T1 = in[i].T1, T2 = in[i].T2;
+    manageLogistics(in[i].LF1, in[i].LF2, in[i].EXP1, in[i].EXP2, T1, T2, in[i].E);
+    return (long long)T1 + T2;
+  });
+
+  int *cols = new int[9 * BATCH_RECORDS];
+  int *LF1 = cols, *LF2 = LF1 + BATCH_RECORDS, *EXP1 = LF2 + BATCH_RECORDS;
+  int *EXP2 = EXP1 + BATCH_RECORDS, *T1 = EXP2 + BATCH_RECORDS, *T2 = T1 + BATCH_RECORDS;
+  int *E = T2 + BATCH_RECORDS, *T1in = E + BATCH_RECORDS, *T2in = T1in + BATCH_RECORDS;
+  for (int r = 0; r < BATCH_RECORDS; r++) {
+    const LogisticsInput &x = in[r % POOL];
+    LF1[r] = x.LF1; LF2[r] = x.LF2; EXP1[r] = x.EXP1; EXP2[r] = x.EXP2;
+    T1in[r] = x.T1; T2in[r] = x.T2; E[r] = x.E;
+  }
+  runBench(opt, "manageLogisticsBatch", 16, BATCH_RECORDS, [&](int i) {
+    memcpy(T1, T1in, BATCH_RECORDS * sizeof(int));
+    memcpy(T2, T2in, BATCH_RECORDS * sizeof(int));
+    manageLogisticsBatch(LF1, LF2, EXP1, EXP2, T1, T2, E, BATCH_RECORDS);
+    return (long long)T1[i];
+  });
+  delete[] cols;
+}
+
+void benchAttack(const Options &opt) {
+  Rng rng(opt.seed ^ 4);
+  static int field[POOL][10][10];
+  static LogisticsInput in[POOL];
+  for (int i = 0; i < POOL; i++) { genField(rng, field[i]); genLogistics(rng, in[i]); }
+  runBench(opt, "planAttack", POOL, 1, [&](int i) {
+    return (long long)planAttack(in[i].LF1, in[i].LF2, in[i].EXP1, in[i].EXP2, in[i].T1, in[i].T2, field[i]);
+  });
+  runBench(opt, "planAttackGrid", POOL, 1, [&](int i) {
+    return (long long)planAttackGrid(in[i].LF1, in[i].LF2, in[i].EXP1, in[i].EXP2, in[i].T1, in[i].T2,
+                                     &field[i][0][0], 10, 10);
+  });
+  BattlefieldScore score(in[0].LF1, in[0].LF2, in[0].EXP1, in[0].EXP2, in[0].T1, in[0].T2, field[0]);
+  runBench(opt, "BattlefieldScore::setCell+score", POOL, 1, [&](int i) {
+    score.setCell(i % 10, (i / 10) % 10, field[i][0][0]);
+    return (long long)score.score();
+  });
+}
+
+void benchResupply(const Options &opt) {
+  Rng rng(opt.seed ^ 5);
+  static int supply[POOL][5][5], shortfall[POOL];
+  for (int i = 0; i < POOL; i++) genSupply(rng, supply[i], shortfall[i]);
+  runBench(opt, "resupply", POOL, 1, [&](int i) {
+    return (long long)resupply(shortfall[i], supply[i]);
+  });
+  runBench(opt, "resupplyPick", POOL, 1, [&](int i) {
+    int picked[5];
+    return (long long)resupplyPick(shortfall[i], &supply[i][0][0], 25, 5, picked);
+  });
+  runBench(opt, "ResupplyIndex::build", 64, 1, [&](int i) {
+    ResupplyIndex index(supply[i]);
+    return (long long)index.size();
+  });
+  ResupplyIndex index(supply[0]);
+  runBench(opt, "ResupplyIndex::query", POOL, 1, [&](int i) {
+    return (long long)index.query(shortfall[i]);
+  });
+  runBench(opt, "ResupplyPlanner::next x10", 64, 10, [&](int i) {
+    ResupplyPlanner planner(supply[i], shortfall[i]);
+    int total, row[5], col[5];
+    long long acc = 0;
+    for (int k = 0; k < 10 && planner.next(total, row, col); k++) acc += total;
+    return acc;
+  });
+}
+
+void benchLoader(const Options &opt) {
+  Rng rng(opt.seed ^ 6);
+  string text;
+  for (int i = 0; i < POOL; i++) text += genScenarioText(rng);
+  runBench(opt, "parseScenarios", 4, POOL, [&](int) {
+    int count;
+    Scenario *sc = parseScenarios(text.data(), text.size(), count);
+    long long acc = sc[count - 1].T1;
+    delete[] sc;
+    return acc;
+  });
+}
+
+int main(int argc, char *argv[]) {
+  Options opt = {1, 50, nullptr};
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (strcmp(argv[i], "--seed") == 0) opt.seed = strtoull(argv[i + 1], nullptr, 10);
+    else if (strcmp(argv[i], "--reps") == 0) opt.reps = max(1, atoi(argv[i + 1]));
+    else if (strcmp(argv[i], "--filter") == 0) opt.filter = argv[i + 1];
+    else {
+      fprintf(stderr, "Usage: %s [--seed N] [--reps N] [--filter TEXT]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  printf("# seed %llu, reps %d, warmup %d, compiler %s\n", opt.seed, opt.reps, WARMUP_REPS, __VERSION__);
+  printf("bench\titems\treps\tmean_ns\tmin_ns\tp50_ns\tp90_ns\tp99_ns\tmax_ns\n");
+  benchLoader(opt);
+  benchForces(opt);
+  benchTargets(opt);
+  benchLogistics(opt);
+  benchAttack(opt);
+  benchResupply(opt);
+  return 0;
+}
@@ -0,0 +1 @@
+g++ -O2 -o bench_tnc bench_tnc.cpp tay_nguyen_campaign.cpp -I . -std=c++11 && ./bench_tnc "$@"
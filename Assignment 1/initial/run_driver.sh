@@ -0,0 +1 @@
+g++ -O2 -pthread -o tnc_driver tnc_driver.cpp tay_nguyen_campaign.cpp -I . -std=c++11 && ./tnc_driver "${1:-tnc_archive_sample}" "${2:-tnc_driver_output}" $3
@@ -9,6 +9,22 @@
 const int MAX_LINES = 5;         
 const int MAX_LINE_LENGTH = 100;
 const int MAX_LF_SIZE = 17;
+const int FORCE_WEIGHT[MAX_LF_SIZE] = {1, 2, 3, 4, 5, 7, 8, 9, 10,
+                                      12, 15, 18, 20, 30, 40, 50, 70};
+const int FORCE_BLOCK = 2048;  // records per block in gatherForcesRange
+const int FORCE_CHUNK = 64;    // records per vectorized step of a block
+const int LOGISTICS_BLOCK = 1024; // records per block in manageLogisticsBatch
+const long long RESUPPLY_MAX_TABLE = 1 << 24;      // 64-bit words of a resupply DP table
+const long long RESUPPLY_MAX_WORK = 1LL << 30;     // word updates of a resupply DP pass
+const long long RESUPPLY_MAX_STEPS = 1LL << 25;    // search steps when the DP is too large
+const long long RESUPPLY_FIRST_STEPS = 1 << 14;    // search steps before outliers are set aside
+const int RESUPPLY_MAX_OUTLIERS = 6;               // values the resupply DP may set aside
+const int ATTACK_ROW_CHUNK = 64;                    // cells per vectorized step of sumRow
+const double ATTACK_MAX_DRIFT = 0.125;             // below 1/6, the gap of a non-integer score
+const double DOUBLE_UNIT = 1.0 / 9007199254740992.0; // 2^-53, the error of one double rounding
+
+ArithmeticMode arithmeticModeValue = DOUBLE_ARITHMETIC;
+long long arithmeticMismatchCount = 0;
 
 int clamp(int val, int min, int max) {
   if (val < min) return min;
@@ -127,91 +143,309 @@ bool readFile(
   return true;
 }
 
+// Helper functions for the scenario loader, working on [p, e) in place.
+// They accept exactly what parseLF / parseEXP_T / parseE accept.
+bool isSpaceChar(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+bool isDigitChar(char c) {
+  return c >= '0' && c <= '9';
+}
+
+bool isBracket(char c) {
+  return c == '[' || c == ']';
+}
+
+// Optional sign and at least one digit, range-checked like stoi / operator>>.
+// With brackets set, '[' and ']' are skipped anywhere (parseLF drops them).
+// Returns the position after the number, or nullptr if there is none.
+const char *scanNumber(const char *p, const char *e, bool brackets, int &val) {
+  while (brackets && p < e && isBracket(*p)) p++;
+  bool negative = false;
+  if (p < e && (*p == '+' || *p == '-')) {
+    negative = (*p == '-');
+    p++;
+    while (brackets && p < e && isBracket(*p)) p++;
+  }
+  if (p == e || !isDigitChar(*p)) return nullptr;
+
+  long long v = 0;
+  for (; p < e; p++) {
+    char c = *p;
+    if (isDigitChar(c)) {
+      v = v * 10 + (c - '0');
+      if (v > (long long)INT_MAX + 1) return nullptr;
+    } else if (!brackets || !isBracket(c)) {
+      break;
+    }
+  }
+  if (negative) v = -v;
+  if (v > INT_MAX || v < INT_MIN) return nullptr;
+  val = v;
+  return p;
+}
+
+// Same tokens as parseLF: comma-separated, each read like stoi
+bool scanLF(const char *p, const char *e, int LF[], int size, int minVal, int maxVal) {
+  int idx = 0;
+  while (idx < size) {
+    const char *t = p;
+    while (t < e && isBracket(*t)) t++;
+    if (t == e) break; // nothing left, not even an empty last token
+
+    // stoi skips leading whitespace and ignores anything after the number
+    while (t < e && (isBracket(*t) || isSpaceChar(*t))) t++;
+    int val;
+    p = scanNumber(t, e, true, val);
+    if (p == nullptr) return false;
+    LF[idx++] = clamp(val, minVal, maxVal);
+
+    while (p < e && *p != ',') p++;
+    if (p == e) break;
+    p++;
+  }
+
+  for (int i = idx; i < size; i++) {
+    LF[i] = 0;
+  }
+  return true;
+}
+
+// Same as `ss >> val` in parseEXP_T / parseE
+const char *scanValue(const char *p, const char *e, int &val) {
+  while (p < e && isSpaceChar(*p)) p++;
+  return scanNumber(p, e, false, val);
+}
+
+int parseScenario(const char *line[], const char *lineEnd[], Scenario &sc) {
+  if (!scanLF(line[0], lineEnd[0], sc.LF1, MAX_LF_SIZE, 0, 1000)) return 1;
+  if (!scanLF(line[1], lineEnd[1], sc.LF2, MAX_LF_SIZE, 0, 1000)) return 2;
+
+  const char *p = scanValue(line[2], lineEnd[2], sc.EXP1);
+  if (p == nullptr || scanValue(p, lineEnd[2], sc.EXP2) == nullptr) return 3;
+  sc.EXP1 = clamp(sc.EXP1, 0, 600);
+  sc.EXP2 = clamp(sc.EXP2, 0, 600);
+
+  p = scanValue(line[3], lineEnd[3], sc.T1);
+  if (p == nullptr || scanValue(p, lineEnd[3], sc.T2) == nullptr) return 4;
+  sc.T1 = clamp(sc.T1, 0, 3000);
+  sc.T2 = clamp(sc.T2, 0, 3000);
+
+  if (scanValue(line[4], lineEnd[4], sc.E) == nullptr) return 5;
+  sc.E = clamp(sc.E, 0, 99);
+  return 0;
+}
+
+Scenario *parseScenarios(const char data[], long long size, int &count) {
+  const char *end = data + size;
+
+  // Whitespace after the last scenario is not another scenario
+  while (end > data && isSpaceChar(end[-1])) end--;
+
+  long long lines = (end > data) ? 1 : 0;
+  for (const char *p = data; (p = (const char *)memchr(p, '\n', end - p)) != nullptr; p++) {
+    lines++;
+  }
+  count = (lines + MAX_LINES - 1) / MAX_LINES;
+  Scenario *out = new Scenario[count > 0 ? count : 1];
+
+  const char *p = data;
+  for (int r = 0; r < count; r++) {
+    const char *line[MAX_LINES], *lineEnd[MAX_LINES];
+    int got = 0;
+    while (got < MAX_LINES && p < end) {
+      const char *q = (const char *)memchr(p, '\n', end - p);
+      if (q == nullptr) q = end;
+      line[got] = p;
+      lineEnd[got++] = q;
+      p = (q < end) ? q + 1 : end;
+    }
+
+    Scenario &sc = out[r];
+    if (got < MAX_LINES) {
+      memset(&sc, 0, sizeof(sc));
+      sc.error = got + 1; // the file ended inside this scenario
+    } else {
+      sc.error = parseScenario(line, lineEnd, sc);
+    }
+  }
+  return out;
+}
+
+// Helper function: whole file in one bulk read, as a new[] buffer
+char *readWholeFile(const string &filename, long long &size) {
+  size = 0;
+  ifstream ifs(filename, ios::binary);
+  if (!ifs.is_open()) {
+    return nullptr;
+  }
+
+  ifs.seekg(0, ios::end);
+  size = ifs.tellg();
+  ifs.seekg(0, ios::beg);
+  if (size < 0) size = 0;
+  char *data = new char[size > 0 ? size : 1];
+  ifs.read(data, size);
+  size = ifs.gcount();
+  ifs.close();
+  return data;
+}
+
+Scenario *readScenarios(const string &filename, int &count) {
+  count = 0;
+  long long size;
+  char *data = readWholeFile(filename, size);
+  if (data == nullptr) {
+    return nullptr;
+  }
+
+  // The scanner works on the buffer in place
+  Scenario *out = parseScenarios(data, size, count);
+  delete[] data;
+  return out;
+}
+
 // Task 1
 int gatherForces(int LF1[], int LF2[])
 {
   // TODO: Implement this function
 
   int LF = 0;
-  int weight[17] = {1, 2, 3, 4, 5, 7, 8, 9, 10,
-                    12, 15, 18, 20, 30, 40, 50, 70};
-  for (int i = 0; i < 17; i++)
+  for (int i = 0; i < MAX_LF_SIZE; i++)
   {
     LF1[i] = clamp(LF1[i], 0, 1000);
     LF2[i] = clamp(LF2[i], 0, 1000);
-    LF += (LF1[i] + LF2[i]) * weight[i];
+    LF += (LF1[i] + LF2[i]) * FORCE_WEIGHT[i];
   }
   // cout << LF << " " << LF11 << " " << LF22 << endl;
   return LF;
 }
 
-// Task 2
-string determineRightTarget(const string &target)
+// Task 1 (batch)
+void gatherForcesRange(const int LF1[], const int LF2[], int n, int begin, int end, int result[])
 {
-  int number[4], count = 0;
-  stringstream ss(target);
-  string code;
-  
-  while (ss >> code) {
-    string extractedNum = "";
-    for (char c : code) {
-      if (isdigit(c)) {
-        extractedNum += c;
-      }
-      else if (!extractedNum.empty()) {
-        int num = stoi(extractedNum);
-        if (num >= 0 && num <= 100) {
-          if (count < 4) {
-            number[count++] = num;
-          }
-          else {
-            return "INVALID";
-          }
+  // Blocks keep the partial sums in cache while the 17 columns stream past.
+  // The sums live in a local array, which cannot alias the columns, and the
+  // inner loop runs in chunks of known length: -O2 vectorizes only loops
+  // like that, with no aliasing checks at run time.
+  int sum[FORCE_BLOCK];
+  for (int lo = begin; lo < end; lo += FORCE_BLOCK) {
+    int len = min(end - lo, FORCE_BLOCK);
+    for (int r = 0; r < len; r++) sum[r] = 0;
+    for (int i = 0; i < MAX_LF_SIZE; i++) {
+      const int *col1 = LF1 + (long long)i * n + lo;
+      const int *col2 = LF2 + (long long)i * n + lo;
+      const int w = FORCE_WEIGHT[i];
+      int r = 0;
+      for (; r + FORCE_CHUNK <= len; r += FORCE_CHUNK) {
+        for (int k = 0; k < FORCE_CHUNK; k++) {
+          int a = min(max(col1[r + k], 0), 1000);
+          int b = min(max(col2[r + k], 0), 1000);
+          sum[r + k] += (a + b) * w;
         }
-        extractedNum = "";
       }
-    }
-      
-    if (!extractedNum.empty()) {
-      int num = stoi(extractedNum);
-      if (num >= 0 && num <= 100) {
-        if (count < 4) {
-          number[count++] = num;
-        }
-        else {
-          return "INVALID";
-        }
+      for (; r < len; r++) {
+        int a = min(max(col1[r], 0), 1000);
+        int b = min(max(col2[r], 0), 1000);
+        sum[r] += (a + b) * w;
       }
     }
+    for (int r = 0; r < len; r++) result[lo + r] = sum[r];
+  }
+}
+
+void gatherForcesBatch(const int LF1[], const int LF2[], int n, int result[])
+{
+  gatherForcesRange(LF1, LF2, n, 0, n, result);
+}
+
+// Helper function for determineRightTarget: name of a target id
+const char *targetName(int id) {
+  static const char *names[] = {
+    "Buon Ma Thuot", "Duc Lap", "Dak Lak", "National Route 21", "National Route 14"
+  };
+  if (id >= 3 && id <= 7) return names[id - 3];
+  if (id >= 0 && id <= 2) return "DECOY";
+  return "INVALID";
+}
+
+// Task 2 (scanner)
+int determineRightTargetId(const char target[], long long len)
+{
+  int number[3], count = 0;
+  long long i = 0;
+  while (i < len) {
+    if (!isDigitChar(target[i])) {
+      i++;
+      continue;
+    }
+
+    // One run of digits; anything above 100 is out of range, so the value
+    // is capped there instead of being parsed in full
+    int num = 0;
+    while (i < len && isDigitChar(target[i])) {
+      num = min(num * 10 + (target[i] - '0'), 101);
+      i++;
+    }
+    if (num <= 100) {
+      if (count == 3) return -1; // a 4th number makes the message INVALID
+      number[count++] = num;
+    }
   }
 
-  int id = 0;
   if (count == 1) {
-      id = number[0];
-      if (id == 3) return "Buon Ma Thuot";
-      if (id == 4) return "Duc Lap";
-      if (id == 5) return "Dak Lak";
-      if (id == 6) return "National Route 21";
-      if (id == 7) return "National Route 14";
-      if (id >= 0 && id <= 2) return "DECOY";
-      return "INVALID"; // Must return something for all cases
+    return (number[0] <= 7) ? number[0] : -1;
   }
   else if (count == 2) {
-      id = (number[0] + number[1]) % 5 + 3;
+    return (number[0] + number[1]) % 5 + 3;
   }
   else if (count == 3) {
-      id = max(number[0], max(number[1], number[2])) % 5 + 3;
+    return max(number[0], max(number[1], number[2])) % 5 + 3;
   }
-  else {
-    return "INVALID"; // Case: no valid numbers found
+  return -1; // Case: no valid numbers found
+}
+
+// Task 2
+string determineRightTarget(const string &target)
+{
+  return targetName(determineRightTargetId(target.data(), target.size()));
+}
+
+// Task 2 (bulk)
+long long determineRightTargets(const char messages[], long long len, ostream &out)
+{
+  long long lines = 0;
+  const char *p = messages, *end = messages + len;
+  while (p < end) {
+    const char *q = (const char *)memchr(p, '\n', end - p);
+    if (q == nullptr) q = end;
+
+    const char *name = targetName(determineRightTargetId(p, q - p));
+    out.write(name, strlen(name));
+    out.put('\n');
+    lines++;
+    p = q + 1;
   }
+  return lines;
+}
 
-  if (id == 3) return "Buon Ma Thuot";
-  if (id == 4) return "Duc Lap";
-  if (id == 5) return "Dak Lak";
-  if (id == 6) return "National Route 21";
-  if (id == 7) return "National Route 14";
-  return "INVALID";
+bool determineRightTargetsFile(const string &inFile, const string &outFile)
+{
+  long long size;
+  char *data = readWholeFile(inFile, size);
+  if (data == nullptr) {
+    return false;
+  }
+
+  ofstream ofs(outFile, ios::binary);
+  if (!ofs.is_open()) {
+    delete[] data;
+    return false;
+  }
+  determineRightTargets(data, size, ofs);
+  delete[] data;
+  return (bool)ofs;
 }
 
 // Helper function for decodeTarget
@@ -219,72 +453,397 @@ string validTargets[] = {
   "Buon Ma Thuot", "Duc Lap", "Dak Lak", "National Route 21", "National Route 14"
 };
 
-string tolowerCase(const string &s) {
-  string result = s;
-  for (char &c : result) {
-      if (c >= 'A' && c <= 'Z') {
-          c = tolower(c);
-      }
-  }
-  return result;
+// validTargets case-folded, and a perfect hash on the last character:
+// 't', 'p', 'k', '1' and '4' all differ modulo 13
+const int MAX_TARGET_LENGTH = 17;
+const char *const foldedTargets[5] = {
+  "buon ma thuot", "duc lap", "dak lak", "national route 21", "national route 14"
+};
+const int foldedTargetLength[5] = {13, 7, 7, 17, 17};
+
+constexpr int targetHash(char last) {
+  return (unsigned char)last % 13;
 }
 
-// Hàm giải mã Caesar Cipher
-string caesarCipherDecode(const string &message, int shift) {
-  string decoded;
-  for (char c : message) {
-      if (!isalnum(c) && c != ' ') return "INVALID"; // Kiểm tra ký tự hợp lệ
-      if (isalpha(c)) {
-          char base = islower(c) ? 'a' : 'A';
-          decoded += (c - base + shift) % 26 + base;
-      } else {
-          decoded += c;
-      }
-  }
-  return decoded;
+constexpr int targetSlot[13] = {4, -1, -1, 2, -1, -1, -1, -1, 1, -1, 3, -1, 0};
+
+static_assert(targetSlot[targetHash('t')] == 0 && targetSlot[targetHash('p')] == 1 &&
+              targetSlot[targetHash('k')] == 2 && targetSlot[targetHash('1')] == 3 &&
+              targetSlot[targetHash('4')] == 4, "targetSlot does not match validTargets");
+
+// Index in validTargets of a case-folded message, or -1
+int matchTarget(const char folded[], int len) {
+  if (len == 0) return -1;
+  int slot = targetSlot[targetHash(folded[len - 1])];
+  if (slot < 0 || foldedTargetLength[slot] != len) return -1;
+  return (memcmp(folded, foldedTargets[slot], len) == 0) ? slot : -1;
 }
 
-// Hàm đảo ngược chuỗi
-string reverseString(string message) {
-  for (char c : message) {
-    if (!isalnum(c) && c != ' ') {
-      return "INVALID";
+// Task 2.2 (scanner)
+int decodeTargetId(const char message[], long long len, int EXP1, int EXP2)
+{
+  EXP1 = clamp(EXP1, 0, 600); EXP2 = clamp(EXP2, 0, 600);
+
+  // Longer messages cannot decode to any target
+  if (len > MAX_TARGET_LENGTH) return -1;
+
+  // Caesar shift, or reading backwards, folded to lower case in the same pass
+  bool caesar = (EXP1 >= 300 && EXP2 >= 300);
+  int shift = caesar ? (EXP1 + EXP2) % 26 : 0;
+  char folded[MAX_TARGET_LENGTH];
+  for (int i = 0; i < len; i++) {
+    char c = caesar ? message[i] : message[len - 1 - i];
+    char lower = c | 0x20;
+    if (lower >= 'a' && lower <= 'z') {
+      folded[i] = 'a' + (lower - 'a' + shift) % 26;
+    } else if (isDigitChar(c) || c == ' ') {
+      folded[i] = c;
+    } else {
+      return -1; // Kiểm tra ký tự hợp lệ
     }
   }
+  return matchTarget(folded, len);
+}
+
+// Task 2.2 (shift search)
+int searchTargets(const char message[], long long len, int target[], int shift[])
+{
+  if (len > MAX_TARGET_LENGTH || len == 0) return 0;
+
+  // Fold once; the same characters as decodeTarget are allowed
+  char folded[MAX_TARGET_LENGTH];
+  for (int i = 0; i < len; i++) {
+    char c = message[i];
+    char lower = c | 0x20;
+    if (lower >= 'a' && lower <= 'z') folded[i] = lower;
+    else if (isDigitChar(c) || c == ' ') folded[i] = c;
+    else return 0;
+  }
+
+  int count = 0;
+  for (int t = 0; t < 5; t++) {
+    if (foldedTargetLength[t] != len) continue;
+    const char *name = foldedTargets[t];
+
+    // Every target starts with a letter, which fixes the only shift that
+    // can work; the other 25 need not be tried
+    if (folded[0] >= 'a' && folded[0] <= 'z') {
+      int s = (name[0] - folded[0] + 26) % 26;
+      bool ok = true;
+      for (int i = 0; i < len && ok; i++) {
+        char c = folded[i];
+        if (c >= 'a' && c <= 'z') c = 'a' + (c - 'a' + s) % 26;
+        ok = (c == name[i]);
+      }
+      if (ok) {
+        target[count] = t;
+        shift[count++] = s;
+      }
+    }
 
-  int left = 0, right = message.length() - 1;
-  while (left < right) {
-      char temp = message[left];
-      message[left] = message[right];
-      message[right] = temp;
-      left++;
-      right--;
+    // The message read backwards, as decodeTarget does for low EXP
+    bool ok = true;
+    for (int i = 0; i < len && ok; i++) {
+      ok = (folded[len - 1 - i] == name[i]);
+    }
+    if (ok) {
+      target[count] = t;
+      shift[count++] = REVERSED_SHIFT;
+    }
   }
-  return message;
+  return count;
 }
 
 // Task 2.2
 string decodeTarget(const string &message, int EXP1, int EXP2)
 {
-  // TODO: Implement this function
-  EXP1 = clamp(EXP1, 0, 600); EXP2 = clamp(EXP2, 0, 600);
-  string decodedMessage;
-    
-  if (EXP1 >= 300 && EXP2 >= 300) {
-      int shift = (EXP1 + EXP2) % 26;
-      decodedMessage = caesarCipherDecode(message, shift);
-      // cout << decodedMessage << endl;
-      // if (decodedMessage == "INVALID") return "INVALID";
-  } else {
-      decodedMessage = reverseString(message);
-      // cout << decodedMessage << endl;
+  int id = decodeTargetId(message.data(), message.size(), EXP1, EXP2);
+  return (id >= 0) ? validTargets[id] : "INVALID";
+}
+
+// Code of a DecodeCache key read by determineRightTarget; decodeTarget keys
+// use the shift 0..25 or REVERSED_SHIFT
+const int RIGHT_TARGET_CODE = -2;
+
+struct DecodeCache::Entry {
+  char key[DECODE_CACHE_KEY];
+  int len, code;
+  int value;        // the target id the uncached function returns
+  unsigned hash;
+  int prev, next;   // LRU list, most recent first
+  int chain;        // next entry in the same bucket
+};
+
+// One LRU list with its hash buckets. Entries are only ever recycled, never
+// freed, so a shard's memory is fixed once built.
+struct DecodeCache::Shard {
+  Entry *entries;
+  int capacity, used;
+  int *bucket;      // first entry of each bucket, or -1
+  unsigned mask;    // buckets - 1, a power of two minus one
+  int head, tail;
+  bool locked;
+
+  void lock() {
+    while (__atomic_test_and_set(&locked, __ATOMIC_ACQUIRE)) {
+    }
   }
-   
-  for (int i = 0; i < 5; i++) {
-      if (tolowerCase(decodedMessage) == tolowerCase(validTargets[i])) return validTargets[i];
+
+  void unlock() {
+    __atomic_clear(&locked, __ATOMIC_RELEASE);
   }
 
-  return "INVALID";
+  int find(const char key[], int len, int code, unsigned hash) const {
+    for (int i = bucket[hash & mask]; i >= 0; i = entries[i].chain) {
+      const Entry &e = entries[i];
+      if (e.hash == hash && e.len == len && e.code == code && memcmp(e.key, key, len) == 0) return i;
+    }
+    return -1;
+  }
+
+  void unlink(int i) {
+    Entry &e = entries[i];
+    if (e.prev >= 0) entries[e.prev].next = e.next; else head = e.next;
+    if (e.next >= 0) entries[e.next].prev = e.prev; else tail = e.prev;
+  }
+
+  void pushFront(int i) {
+    entries[i].prev = -1;
+    entries[i].next = head;
+    if (head >= 0) entries[head].prev = i; else tail = i;
+    head = i;
+  }
+
+  // Takes a free entry, or evicts the least recently used one
+  int claim() {
+    if (used < capacity) return used++;
+    int i = tail;
+    unlink(i);
+    int *link = &bucket[entries[i].hash & mask];
+    while (*link != i) link = &entries[*link].chain;
+    *link = entries[i].chain;
+    return i;
+  }
+
+  void insert(const char key[], int len, int code, unsigned hash, int value) {
+    int i = claim();
+    Entry &e = entries[i];
+    memcpy(e.key, key, len);
+    e.len = len; e.code = code; e.value = value; e.hash = hash;
+    e.chain = bucket[hash & mask];
+    bucket[hash & mask] = i;
+    pushFront(i);
+  }
+};
+
+DecodeCache::DecodeCache(int capacity, int shards)
+  : shards(nullptr), shardCount(max(1, shards)), hitCount(0), missCount(0)
+{
+  int perShard = max(1, (max(1, capacity) + shardCount - 1) / shardCount);
+  int buckets = 1;
+  while (buckets < perShard) buckets *= 2;
+
+  this->shards = new Shard[shardCount];
+  for (int s = 0; s < shardCount; s++) {
+    Shard &sh = this->shards[s];
+    sh.entries = new Entry[perShard];
+    sh.capacity = perShard;
+    sh.used = 0;
+    sh.bucket = new int[buckets];
+    for (int b = 0; b < buckets; b++) sh.bucket[b] = -1;
+    sh.mask = buckets - 1;
+    sh.head = sh.tail = -1;
+    sh.locked = false;
+  }
+}
+
+DecodeCache::~DecodeCache() {
+  for (int s = 0; s < shardCount; s++) {
+    delete[] shards[s].entries;
+    delete[] shards[s].bucket;
+  }
+  delete[] shards;
+}
+
+// FNV-1a over the message, seeded with how it is read
+unsigned decodeCacheHash(const char key[], long long len, int code) {
+  unsigned h = 2166136261u ^ (unsigned)(code - RIGHT_TARGET_CODE);
+  for (long long i = 0; i < len; i++) {
+    h ^= (unsigned char)key[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+int DecodeCache::lookup(const char key[], long long len, int code, int EXP1, int EXP2) {
+  unsigned hash = decodeCacheHash(key, len, code);
+  Shard &sh = shards[hash % shardCount];
+  hash /= shardCount; // the bits left over pick the bucket
+
+  sh.lock();
+  int i = sh.find(key, len, code, hash);
+  if (i >= 0) {
+    int value = sh.entries[i].value;
+    sh.unlink(i);
+    sh.pushFront(i);
+    sh.unlock();
+    __atomic_fetch_add(&hitCount, 1, __ATOMIC_RELAXED);
+    return value;
+  }
+  sh.unlock();
+  __atomic_fetch_add(&missCount, 1, __ATOMIC_RELAXED);
+
+  // Computed outside the lock; another thread may have added it meanwhile
+  int value = (code == RIGHT_TARGET_CODE) ? ::determineRightTargetId(key, len)
+                                          : ::decodeTargetId(key, len, EXP1, EXP2);
+  sh.lock();
+  if (sh.find(key, len, code, hash) < 0) sh.insert(key, len, code, hash, value);
+  sh.unlock();
+  return value;
+}
+
+int DecodeCache::determineRightTargetId(const char target[], long long len) {
+  if (len > DECODE_CACHE_KEY) return ::determineRightTargetId(target, len);
+  return lookup(target, len, RIGHT_TARGET_CODE, 0, 0);
+}
+
+int DecodeCache::decodeTargetId(const char message[], long long len, int EXP1, int EXP2) {
+  // Too long to be any target: no need to remember it
+  if (len > MAX_TARGET_LENGTH) return -1;
+  int e1 = clamp(EXP1, 0, 600), e2 = clamp(EXP2, 0, 600);
+  int code = (e1 >= 300 && e2 >= 300) ? (e1 + e2) % 26 : REVERSED_SHIFT;
+  return lookup(message, len, code, EXP1, EXP2);
+}
+
+string DecodeCache::determineRightTarget(const string &target) {
+  return targetName(determineRightTargetId(target.data(), target.size()));
+}
+
+string DecodeCache::decodeTarget(const string &message, int EXP1, int EXP2) {
+  int id = decodeTargetId(message.data(), message.size(), EXP1, EXP2);
+  return (id >= 0) ? validTargets[id] : "INVALID";
+}
+
+long long DecodeCache::hits() const {
+  return __atomic_load_n(&hitCount, __ATOMIC_RELAXED);
+}
+
+long long DecodeCache::misses() const {
+  return __atomic_load_n(&missCount, __ATOMIC_RELAXED);
+}
+
+void setArithmeticMode(ArithmeticMode mode) {
+  arithmeticModeValue = mode;
+  __atomic_store_n(&arithmeticMismatchCount, 0, __ATOMIC_RELAXED);
+}
+
+ArithmeticMode arithmeticMode() {
+  return arithmeticModeValue;
+}
+
+long long arithmeticMismatches() {
+  return __atomic_load_n(&arithmeticMismatchCount, __ATOMIC_RELAXED);
+}
+
+// Helper function for VERIFY_ARITHMETIC: the checked functions may run on
+// several threads at once (tnc_driver), so the count is kept atomically
+inline void countMismatch() {
+  __atomic_fetch_add(&arithmeticMismatchCount, 1, __ATOMIC_RELAXED);
+}
+
+// Helper functions for the exact mode: a/b rounded down or up, for b > 0
+inline long long floorDiv(long long a, long long b) {
+  long long q = a / b;
+  return (a % b < 0) ? q - 1 : q;
+}
+
+inline long long ceilDiv(long long a, long long b) {
+  return -floorDiv(-a, b);
+}
+
+// Helper functions for manageLogistics, one per band of E. The inputs are
+// already clamped. The scalar and the batch version both go through these,
+// so they round exactly alike.
+int logisticsBand(int E) {
+  // E in 0..99 by table lookup rather than a chain of branches
+  static const unsigned char band[100] = {
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4
+  };
+  // outside 0..99 no rule applies and supplies drop to 0
+  return ((unsigned)E < 100) ? band[E] : 5;
+}
+
+// ceil for values well inside the int range, without a libm call or a
+// branch, so the band loops below have no control flow
+inline int roundUp(double x) {
+  int i = (int)x;
+  return i + (i < x);
+}
+
+inline void settleSupplies(double deltaT1, double deltaT2, int &T1, int &T2) {
+  T1 = min(max(roundUp(deltaT1), 0), 3000);
+  T2 = min(max(roundUp(deltaT2), 0), 3000);
+}
+
+inline void settleExact(long long newT1, long long newT2, int &T1, int &T2) {
+  T1 = (int)min(max(newT1, 0LL), 3000LL);
+  T2 = (int)min(max(newT2, 0LL), 3000LL);
+}
+
+// The exact forms keep every share as a fraction of 64-bit integers (all
+// terms stay below 2^55) and round it once:
+//   E == 0:  share = LF1*(T1+T2)*(100+EXP1-EXP2) / ((LF1+LF2)*100),
+//            T1 += ceil(share), T2 = T1 + 2*T2 - floor(share)
+//   1..9:    ceil(T1*(100-E)/100), ceil(T2*(200-E)/200)
+//   30..59:  ceil(T1*(200+E)/200), ceil(T2*(500+E)/500)
+inline void logisticsCalm(int LF1, int LF2, int EXP1, int EXP2, int &T1, int &T2, bool exact) {
+  if (exact) {
+    long long den = ((long long)LF1 + LF2) * 100;
+    if (den == 0) { settleExact(0, 0, T1, T2); return; } // the double form gives NaN
+    long long num = (long long)LF1 * (T1 + T2) * (100 + EXP1 - EXP2);
+    settleExact(T1 + ceilDiv(num, den), T1 + 2LL*T2 - floorDiv(num, den), T1, T2);
+    return;
+  }
+  double deltaT1 = (LF1 / (double)(LF1 + LF2) * (T1 + T2)) * (1 + (EXP1 - EXP2) / 100.0);
+  double deltaT2 = T1 + T2 - deltaT1;
+  settleSupplies(deltaT1 + T1, deltaT2 + T2, T1, T2);
+}
+
+inline void logisticsLoss(int E, int &T1, int &T2, bool exact) {
+  if (exact) {
+    settleExact(ceilDiv(T1 * (100 - E), 100), ceilDiv(T2 * (200 - E), 200), T1, T2);
+    return;
+  }
+  settleSupplies(T1 - E*0.01*T1, T2 - E*0.005*T2, T1, T2);
+}
+
+inline void logisticsResupply(int E, int &T1, int &T2) {
+  settleSupplies(T1 + E*50, T2 + E*50, T1, T2);
+}
+
+inline void logisticsGain(int E, int &T1, int &T2, bool exact) {
+  if (exact) {
+    settleExact(ceilDiv(T1 * (200 + E), 200), ceilDiv(T2 * (500 + E), 500), T1, T2);
+    return;
+  }
+  settleSupplies(T1 + E*0.005*T1, T2 + E*0.002*T2, T1, T2);
+}
+
+// Helper function for manageLogistics: inputs already clamped
+void logisticsApply(int LF1, int LF2, int EXP1, int EXP2, int &T1, int &T2, int E, bool exact) {
+  switch (logisticsBand(E)) {
+    case 0: logisticsCalm(LF1, LF2, EXP1, EXP2, T1, T2, exact); break;
+    case 1: logisticsLoss(E, T1, T2, exact); break;
+    case 2: logisticsResupply(E, T1, T2); break;
+    case 3: logisticsGain(E, T1, T2, exact); break;
+    case 4: break; // supplies already clamped
+    default: settleSupplies(0, 0, T1, T2); break;
+  }
 }
 
 // Task 3
@@ -294,108 +853,1048 @@ void manageLogistics(int LF1, int LF2, int EXP1, int EXP2, int &T1, int &T2, int
   LF1 = max(0, LF1); LF2 = max(0, LF2);
   EXP1 = clamp(EXP1, 0, 600); EXP2 = clamp(EXP2, 0, 600);
   T1 = clamp(T1, 0, 3000); T2 = clamp(T2, 0, 3000);
-  double deltaT1 = 0, deltaT2 = 0;
-  if (E == 0) {
-    deltaT1 = (LF1 / (double)(LF1 + LF2) * (T1 + T2)) * (1 + (EXP1 - EXP2) / 100.0);
-    deltaT2 = T1 + T2 - deltaT1;
-    deltaT1 += T1;
-    deltaT2 += T2;
-  }
-  else if (E >= 1 && E <= 9) {
-    deltaT1 = T1 - E*0.01*T1;
-    deltaT2 = T2 - E*0.005*T2;
-  }
-  else if (E >= 10 && E <= 29) {
-    deltaT1 = T1 + E*50;
-    deltaT2 = T2 + E*50;
-  }
-  else if (E >= 30 && E <= 59) {
-    deltaT1 = T1 + E*0.005*T1;
-    deltaT2 = T2 + E*0.002*T2;
-  }
-  else if (E >= 60 && E <= 99) {
-    T1 = clamp(T1, 0, 3000);
-    T2 = clamp(T2, 0, 3000);
+  if (arithmeticModeValue != VERIFY_ARITHMETIC) {
+    logisticsApply(LF1, LF2, EXP1, EXP2, T1, T2, E, arithmeticModeValue == EXACT_ARITHMETIC);
     return;
   }
-
-  T1 = ceil(deltaT1); T2 = ceil(deltaT2);
-  T1 = clamp(T1, 0, 3000);
-  T2 = clamp(T2, 0, 3000);
+  int checkT1 = T1, checkT2 = T2;
+  logisticsApply(LF1, LF2, EXP1, EXP2, T1, T2, E, true);
+  logisticsApply(LF1, LF2, EXP1, EXP2, checkT1, checkT2, E, false);
+  if (checkT1 != T1 || checkT2 != T2) countMismatch();
 }
 
-// Task 4
-int planAttack(int LF1, int LF2, int EXP1, int EXP2, int T1, int T2, int battleField[10][10])
+// Task 3 (batch)
+void manageLogisticsBatch(const int LF1[], const int LF2[], const int EXP1[], const int EXP2[],
+                          int T1[], int T2[], const int E[], int n)
 {
-  // TODO: Implement this function
+  // Block by block: group the records by band of E (counting sort) into
+  // contiguous copies, run every band as one loop with no branch on E, then
+  // write T1/T2 back. The double band loops are branch-free; -O3 -mavx2
+  // vectorizes them, while SSE2 has no packed double-to-int ceil to use
+  if (arithmeticModeValue == VERIFY_ARITHMETIC) {
+    for (int r = 0; r < n; r++) manageLogistics(LF1[r], LF2[r], EXP1[r], EXP2[r], T1[r], T2[r], E[r]);
+    return;
+  }
+  const bool exact = (arithmeticModeValue == EXACT_ARITHMETIC);
+  const int BANDS = 6;
+  int order[LOGISTICS_BLOCK];
+  int lf1[LOGISTICS_BLOCK], lf2[LOGISTICS_BLOCK], exp1[LOGISTICS_BLOCK], exp2[LOGISTICS_BLOCK];
+  int t1[LOGISTICS_BLOCK], t2[LOGISTICS_BLOCK], e[LOGISTICS_BLOCK];
+
+  for (int lo = 0; lo < n; lo += LOGISTICS_BLOCK) {
+    int hi = min(n, lo + LOGISTICS_BLOCK);
+
+    int start[BANDS + 1] = {0};
+    for (int r = lo; r < hi; r++) start[logisticsBand(E[r]) + 1]++;
+    for (int b = 0; b < BANDS; b++) start[b + 1] += start[b];
+    int next[BANDS];
+    for (int b = 0; b < BANDS; b++) next[b] = start[b];
+    for (int r = lo; r < hi; r++) {
+      int i = next[logisticsBand(E[r])]++;
+      order[i] = r;
+      lf1[i] = max(0, LF1[r]); lf2[i] = max(0, LF2[r]);
+      exp1[i] = clamp(EXP1[r], 0, 600); exp2[i] = clamp(EXP2[r], 0, 600);
+      t1[i] = clamp(T1[r], 0, 3000); t2[i] = clamp(T2[r], 0, 3000);
+      e[i] = E[r];
+    }
+
+    // exact is tested once per block, so the band loops have no branch
+    if (exact) {
+      for (int i = start[0]; i < start[1]; i++) logisticsCalm(lf1[i], lf2[i], exp1[i], exp2[i], t1[i], t2[i], true);
+      for (int i = start[1]; i < start[2]; i++) logisticsLoss(e[i], t1[i], t2[i], true);
+      for (int i = start[3]; i < start[4]; i++) logisticsGain(e[i], t1[i], t2[i], true);
+    }
+    else {
+      for (int i = start[0]; i < start[1]; i++) logisticsCalm(lf1[i], lf2[i], exp1[i], exp2[i], t1[i], t2[i], false);
+      for (int i = start[1]; i < start[2]; i++) logisticsLoss(e[i], t1[i], t2[i], false);
+      for (int i = start[3]; i < start[4]; i++) logisticsGain(e[i], t1[i], t2[i], false);
+    }
+    for (int i = start[2]; i < start[3]; i++) logisticsResupply(e[i], t1[i], t2[i]);
+    for (int i = start[5]; i < start[6]; i++) settleSupplies(0, 0, t1[i], t2[i]);
+
+    for (int i = 0; i < hi - lo; i++) {
+      T1[order[i]] = t1[i];
+      T2[order[i]] = t2[i];
+    }
+  }
+}
+
+// Helper function for planAttack: score before the battlefield is counted
+long long attackBase(int LF1, int LF2, int EXP1, int EXP2, int T1, int T2) {
   LF1 = max(0, LF1); LF2 = max(0, LF2);
   EXP1 = clamp(EXP1, 0, 600); EXP2 = clamp(EXP2, 0, 600);
   T1 = clamp(T1, 0, 3000); T2 = clamp(T2, 0, 3000);
-  double S = (LF1 + LF2) + (EXP1 + EXP2)*5 + (T1 + T2)*2;
-  for (int i = 0; i < 10; i++) {
-    for (int j = 0; j < 10; j++) {
-      if (i % 2 == 0) {
-        S -= battleField[i][j]*2.0/3.0;
-      }
-      else {
-        S -= battleField[i][j]*3.0/2.0;
-      }
+  return ((long long)LF1 + LF2) + (EXP1 + EXP2)*5 + (T1 + T2)*2;
+}
+
+// Helper function for planAttack: sum of one row and of its absolute values,
+// kept as exact integers. -O2 only vectorizes loops of a known length, so
+// the row goes in blocks of ATTACK_ROW_CHUNK cells and the rest one by one.
+void sumRow(const int row[], int cols, long long &sum, long long &absSum) {
+  long long s = 0, a = 0;
+  int j = 0;
+  for (; j + ATTACK_ROW_CHUNK <= cols; j += ATTACK_ROW_CHUNK) {
+    for (int k = 0; k < ATTACK_ROW_CHUNK; k++) {
+      long long v = row[j + k];
+      s += v;
+      a += v < 0 ? -v : v;
+    }
+  }
+  for (; j < cols; j++) {
+    long long v = row[j];
+    s += v;
+    a += v < 0 ? -v : v;
+  }
+  sum = s;
+  absSum = a;
+}
+
+// Helper function for planAttack: the original score, accumulated cell by
+// cell in doubles in row-major order. This is the reference result; its
+// rounding drifts, so a total that is exactly an integer can come out one
+// higher than the exact ceiling.
+int attackScoreCells(long long base, const int battleField[], int rows, int cols) {
+  double S = base;
+  for (int i = 0; i < rows; i++) {
+    const int *row = battleField + (long long)i * cols;
+    if (i % 2 == 0) {
+      for (int j = 0; j < cols; j++) S -= row[j]*2.0/3.0;
+    }
+    else {
+      for (int j = 0; j < cols; j++) S -= row[j]*3.0/2.0;
     }
   }
   S = ceil(S);
+  if (S < INT_MIN) return INT_MIN; // very large grids
+  if (S > INT_MAX) return INT_MAX;
   return S;
 }
 
-// Task 5
-int resupply(int shortfall, int supply[5][5])
+// Helper function for planAttack: the exact ceiling of
+// base - 2/3*evenSum - 3/2*oddSum. With evenSum = 3*qe + re and oddSum = 2*qo + ro,
+// S = base - 2*qe - 3*qo - (4*re + 9*ro)/6, so only that last fraction is
+// rounded and no product can overflow.
+int attackScoreExact(long long base, long long evenSum, long long oddSum) {
+  long long qe = floorDiv(evenSum, 3), qo = floorDiv(oddSum, 2);
+  long long re = evenSum - 3*qe, ro = oddSum - 2*qo;
+  long long S = base - 2*qe - 3*qo - (4*re + 9*ro) / 6;
+  if (S < INT_MIN) return INT_MIN;
+  if (S > INT_MAX) return INT_MAX;
+  return S;
+}
+
+// Helper function for planAttack: bound on the drift of attackScoreCells over
+// count cells whose absolute values total absSum. No partial sum or term
+// exceeds |base| + 3/2*absSum, and each step rounds by one unit of those.
+double attackDrift(long long base, long long absSum, long long count) {
+  return 2 * DOUBLE_UNIT * (count + 1.0) * (fabs((double)base) + absSum*1.5 + 1);
+}
+
+// Helper function for planAttack: whether the exact ceiling is also what
+// attackScoreCells returns, given a bound on how far its double sum strays
+// from the exact one. A score that is not an integer is at least 1/6 away
+// from one, so a smaller drift rounds up to the same integer.
+bool attackExactMatches(long long evenSum, long long oddSum, double drift) {
+  return (evenSum % 3 != 0 || oddSum % 2 != 0) && drift < ATTACK_MAX_DRIFT;
+}
+
+// Helper function for planAttack: what attackScoreCells returns, from the
+// row totals when they are enough and from the cells otherwise
+int attackScoreDouble(long long base, long long evenSum, long long oddSum, double drift,
+                      const int battleField[], int rows, int cols) {
+  if (attackExactMatches(evenSum, oddSum, drift)) return attackScoreExact(base, evenSum, oddSum);
+  return attackScoreCells(base, battleField, rows, cols);
+}
+
+// Helper function for planAttack: the score in the current mode, from the
+// row totals of the grid; the cells are only read by the double forms
+int attackScore(long long base, long long evenSum, long long oddSum,
+                const int battleField[], int rows, int cols) {
+  if (arithmeticModeValue == DOUBLE_ARITHMETIC) return attackScoreCells(base, battleField, rows, cols);
+  int S = attackScoreExact(base, evenSum, oddSum);
+  if (arithmeticModeValue == VERIFY_ARITHMETIC && S != attackScoreCells(base, battleField, rows, cols)) {
+    countMismatch();
+  }
+  return S;
+}
+
+// Task 4 (general)
+int planAttackGrid(int LF1, int LF2, int EXP1, int EXP2, int T1, int T2,
+                   const int battleField[], int rows, int cols)
 {
-  // TODO: Implement this function
-  int supplies[25]; // Mảng 1D lưu trữ các giá trị của ma trận supply
-  int index = 0;
+  long long base = attackBase(LF1, LF2, EXP1, EXP2, T1, T2);
+
+  const bool fast = (arithmeticModeValue == DOUBLE_ARITHMETIC);
+  if (fast && cols < ATTACK_ROW_CHUNK) {
+    // Narrow rows do not vectorize, and summing them costs about as much as
+    // replaying their cells
+    return attackScoreCells(base, battleField, rows, cols);
+  }
+
+  // Each double subtraction rounds by at most one unit of the larger of |S|
+  // and its term; in a row neither exceeds |S| at the row start plus the
+  // row's terms, which bounds the drift of attackScoreCells row by row.
+  long long evenSum = 0, oddSum = 0;
+  double drift = 0;
+  for (int i = 0; i < rows; i++) {
+    long long sum, absSum;
+    sumRow(battleField + (long long)i * cols, cols, sum, absSum);
+    double reach = fabs(base - evenSum*(2.0/3.0) - oddSum*1.5) + absSum*1.5 + 1;
+    drift += 2 * DOUBLE_UNIT * reach * (cols + 1.0);
+    if (fast && drift >= ATTACK_MAX_DRIFT) {
+      // Too large to skip the cells; stop summing rows that will not be used
+      return attackScoreCells(base, battleField, rows, cols);
+    }
+    if (i % 2 == 0) evenSum += sum;
+    else oddSum += sum;
+  }
+
+  if (fast) return attackScoreDouble(base, evenSum, oddSum, drift, battleField, rows, cols);
+  return attackScore(base, evenSum, oddSum, battleField, rows, cols);
+}
+
+// Task 4
+int planAttack(int LF1, int LF2, int EXP1, int EXP2, int T1, int T2, int battleField[10][10])
+{
+  return planAttackFixed<10, 10>(LF1, LF2, EXP1, EXP2, T1, T2, battleField);
+}
+
+BattlefieldScore::BattlefieldScore(int LF1, int LF2, int EXP1, int EXP2, int T1, int T2,
+                                   const int battleField[], int rows, int cols)
+  : rows(rows), cols(cols), base(attackBase(LF1, LF2, EXP1, EXP2, T1, T2))
+{
+  init(battleField);
+}
+
+BattlefieldScore::BattlefieldScore(int LF1, int LF2, int EXP1, int EXP2, int T1, int T2,
+                                   int battleField[10][10])
+  : rows(10), cols(10), base(attackBase(LF1, LF2, EXP1, EXP2, T1, T2))
+{
+  init(&battleField[0][0]);
+}
+
+BattlefieldScore::~BattlefieldScore() {
+  delete[] cells;
+}
+
+void BattlefieldScore::init(const int battleField[]) {
+  long long size = (long long)rows * cols;
+  cells = new int[size];
+  for (long long i = 0; i < size; i++) cells[i] = battleField[i];
+
+  evenSum = oddSum = absSum = 0;
+  for (int i = 0; i < rows; i++) {
+    long long sum, rowAbs;
+    sumRow(cells + (long long)i * cols, cols, sum, rowAbs);
+    if (i % 2 == 0) evenSum += sum;
+    else oddSum += sum;
+    absSum += rowAbs;
+  }
+}
+
+void BattlefieldScore::setCell(int r, int c, int v) {
+  if (r < 0 || r >= rows || c < 0 || c >= cols) return;
+  int &cell = cells[(long long)r * cols + c];
+  if (r % 2 == 0) evenSum += (long long)v - cell;
+  else oddSum += (long long)v - cell;
+  absSum += (v < 0 ? -(long long)v : v) - (cell < 0 ? -(long long)cell : cell);
+  cell = v;
+}
+
+int BattlefieldScore::getCell(int r, int c) const {
+  if (r < 0 || r >= rows || c < 0 || c >= cols) return 0;
+  return cells[(long long)r * cols + c];
+}
+
+int BattlefieldScore::score() const {
+  if (arithmeticModeValue == DOUBLE_ARITHMETIC) {
+    double drift = attackDrift(base, absSum, (long long)rows * cols);
+    return attackScoreDouble(base, evenSum, oddSum, drift, cells, rows, cols);
+  }
+  return attackScore(base, evenSum, oddSum, cells, rows, cols);
+}
+
+// Helper function for resupply: sort idx[] so that vals[idx[i]] is ascending
+void sortIndicesByValue(const int vals[], int idx[], int n) {
+  // Heap sort, so large supply sets stay O(n log n)
+  for (int i = n / 2 - 1; i >= 0; i--) {
+    for (int root = i; 2 * root + 1 < n; ) {
+      int child = 2 * root + 1;
+      if (child + 1 < n && vals[idx[child + 1]] > vals[idx[child]]) child++;
+      if (vals[idx[root]] >= vals[idx[child]]) break;
+      int temp = idx[root]; idx[root] = idx[child]; idx[child] = temp;
+      root = child;
+    }
+  }
+  for (int end = n - 1; end > 0; end--) {
+    int temp = idx[0]; idx[0] = idx[end]; idx[end] = temp;
+    for (int root = 0; 2 * root + 1 < end; ) {
+      int child = 2 * root + 1;
+      if (child + 1 < end && vals[idx[child + 1]] > vals[idx[child]]) child++;
+      if (vals[idx[root]] >= vals[idx[child]]) break;
+      temp = idx[root]; idx[root] = idx[child]; idx[child] = temp;
+      root = child;
+    }
+  }
+}
+
+// State shared by the branch-and-bound search of resupplyPick
+struct ResupplySearch {
+  const long long *v;   // values sorted ascending
+  const long long *pre; // pre[i] = v[0] + ... + v[i-1]
+  int n, k;
+  long long need;
+  long long floor;      // no k-value total in [need, floor) exists
+  long long best;       // smallest total >= need found so far
+  int *cur;             // positions (in v) picked on the current path
+  int *bestPick;        // positions of the best total
+  long long budget;     // search steps left before giving up
+  const int *out;       // positions of the outliers, ascending
+  int o;
+  long long g, low;     // every other value is congruent to low modulo g
+};
+
+void recordResupply(ResupplySearch &s, long long total) {
+  s.best = total;
+  for (int i = 0; i < s.k; i++) s.bestPick[i] = s.cur[i];
+}
+
+// Helper function for resupplySearch: a lower bound on the totals >= need
+// that r more picks at positions start and later add up to with sum. Such
+// a total is congruent to sum + sum(U) + (r - |U|)*low modulo g, U being
+// the outliers it picks, so the least number >= need in one of those
+// classes bounds it.
+long long resupplyBound(const ResupplySearch &s, int start, int r, long long sum) {
+  int first = 0; // outliers before start can no longer be picked
+  while (first < s.o && s.out[first] < start) first++;
+  int avail = s.o - first;
+  long long bound = LLONG_MAX;
+  for (int mask = 0; mask < (1 << avail); mask++) {
+    int u = __builtin_popcount(mask);
+    if (u > r) continue;
+    long long base = sum + (r - u) * s.low;
+    for (int i = 0; i < avail; i++) if ((mask >> i) & 1) base += s.v[s.out[first + i]];
+    long long t = s.need + (((base - s.need) % s.g) + s.g) % s.g;
+    if (t < bound) bound = t;
+  }
+  return bound;
+}
+
+void resupplySearch(ResupplySearch &s, int start, int depth, long long sum) {
+  int r = s.k - depth; // picks still to make, r >= 1
+  if (s.best == s.floor) return; // cannot be improved
+  if (s.budget == 0) return;
+  s.budget--;
+
+  // Even the r largest values cannot reach the shortfall
+  if (sum + s.pre[s.n] - s.pre[s.n - r] < s.need) return;
 
-  // Flatten ma trận supply thành mảng supplies
-  for (int i = 0; i < 5; ++i) {
-      for (int j = 0; j < 5; ++j) {
-          supplies[index++] = supply[i][j];
+  // No total of the residues left can beat the best one
+  if (s.g > 1 && resupplyBound(s, start, r, sum) >= s.best) return;
+
+  if (r == 1) {
+    // Smallest single value that closes the gap: binary search
+    int lo = start, hi = s.n;
+    while (lo < hi) {
+      int mid = lo + (hi - lo) / 2;
+      if (sum + s.v[mid] >= s.need) hi = mid;
+      else lo = mid + 1;
+    }
+    if (lo < s.n && sum + s.v[lo] < s.best) {
+      s.cur[depth] = lo;
+      recordResupply(s, sum + s.v[lo]);
+    }
+    return;
+  }
+
+  if (r == 2) {
+    // Smallest pair that closes the gap: two pointers, charged per step
+    s.budget = (s.budget > s.n - start) ? s.budget - (s.n - start) : 0;
+    int i = start, j = s.n - 1;
+    while (i < j) {
+      long long total = sum + s.v[i] + s.v[j];
+      if (total >= s.need) {
+        if (total < s.best) {
+          s.cur[depth] = i; s.cur[depth + 1] = j;
+          recordResupply(s, total);
+          if (s.best == s.floor) return;
+        }
+        j--;
+      } else {
+        i++;
       }
+    }
+    return;
   }
 
-  // Sort mảng supplies theo thứ tự tăng dần
-  for (int i = 0; i < 25; ++i) {
-      for (int j = i + 1; j < 25; ++j) {
-          if (supplies[i] > supplies[j]) {
-              int temp = supplies[i];
-              supplies[i] = supplies[j];
-              supplies[j] = temp;
-          }
+  for (int i = start; i <= s.n - r; i++) {
+    // Equal values lead to the same totals as the previous branch
+    if (i > start && s.v[i] == s.v[i - 1]) continue;
+
+    // Cheapest completion starting at i: the run v[i..i+r-1]
+    long long low = sum + s.pre[i + r] - s.pre[i];
+    if (low >= s.best) break;
+    s.cur[depth] = i;
+    if (low >= s.need) {
+      for (int j = 1; j < r; j++) s.cur[depth + j] = i + j;
+      recordResupply(s, low);
+      break; // later starts only give larger totals
+    }
+
+    resupplySearch(s, i + 1, depth + 1, sum + s.v[i]);
+    if (s.best == s.floor || s.budget == 0) return;
+  }
+}
+
+long long gcdOf(long long a, long long b) {
+  while (b != 0) {
+    long long t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+// Helper function for the resupply DP: dst |= src shifted by w bits, up
+// (towards larger totals) or down. src has `words` words; only words
+// [0, span) of dst are written.
+void orShifted(unsigned long long dst[], const unsigned long long src[], long long words,
+               long long span, long long w, bool up) {
+  long long ws = w / 64;
+  int bs = (int)(w % 64);
+  if (up) {
+    if (ws >= span) return;
+    if (bs == 0) {
+      for (long long q = ws; q < span; q++) dst[q] |= src[q - ws];
+      return;
+    }
+    dst[ws] |= src[0] << bs;
+    for (long long q = ws + 1; q < span; q++)
+      dst[q] |= (src[q - ws] << bs) | (src[q - ws - 1] >> (64 - bs));
+  } else {
+    long long end = (words - ws < span) ? words - ws : span;
+    if (end <= 0) return;
+    if (bs == 0) {
+      for (long long q = 0; q < end; q++) dst[q] |= src[q + ws];
+      return;
+    }
+    for (long long q = 0; q + ws + 1 < words && q < end; q++)
+      dst[q] |= (src[q + ws] >> bs) | (src[q + ws + 1] << (64 - bs));
+    if (words - ws - 1 < end) dst[words - ws - 1] |= src[words - 1] >> bs;
+  }
+}
+
+// Helper function for the resupply DP: row j of rows[] (j = 0..k, bitsets of
+// `bits` totals) gets the totals of j values among w[lo..hi-1], w ascending.
+// Going up the empty choice is the total 0 and the values are added in
+// order; going down it is `start` and they are subtracted from the last.
+// Rows stop growing where the k - j picks still to come cannot fit: going
+// up they come after i, so each is >= w[i+1]; going down they come before
+// i, so each is <= w[i-1].
+void resupplyLayers(unsigned long long rows[], int k, long long bits, const long long w[], int n,
+                    int lo, int hi, long long start, bool up) {
+  long long words = (bits + 63) / 64;
+  memset(rows, 0, sizeof(unsigned long long) * words * (k + 1));
+  rows[start / 64] |= 1ULL << (start % 64);
+  for (int step = 0; step < hi - lo; step++) {
+    int i = up ? lo + step : hi - 1 - step;
+    int top = (step + 1 < k) ? step + 1 : k;
+    for (int j = top; j >= 1; j--) {
+      long long room; // largest total (going up) or rest (going down) of row j
+      if (up) {
+        room = bits - 1;
+        if (j < k) room = (i + 1 < n) ? room - (k - j) * w[i + 1] : -1;
+        if (room < w[i]) continue;
+      } else {
+        room = (j < k) ? ((i > 0) ? (k - j) * w[i - 1] : -1) : 0;
+        if (room < 0) continue;
       }
+      long long span = (room / 64 + 1 < words) ? room / 64 + 1 : words;
+      orShifted(rows + j * words, rows + (j - 1) * words, words, span, w[i], up);
+    }
   }
+}
 
-  // Tìm tổ hợp 5 ô có tổng giá trị nhỏ nhất và thỏa mãn điều kiện
-  int min_total_supply = INT_MAX;
-
-  // Duyệt qua tất cả các tổ hợp 5 ô
-  for (int i = 0; i < 21; ++i) {
-      for (int j = i + 1; j < 22; ++j) {
-          for (int k = j + 1; k < 23; ++k) {
-              for (int l = k + 1; l < 24; ++l) {
-                  for (int m = l + 1; m < 25; ++m) {
-                      // Tính tổng của 5 giá trị
-                      int totalSupply = supplies[i] + supplies[j] + supplies[k] + supplies[l] + supplies[m];
-
-                      // Kiểm tra xem tổng có thỏa mãn yêu cầu không
-                      if (totalSupply >= shortfall && totalSupply < min_total_supply) {
-                          min_total_supply = totalSupply;
-                          // cout << supplies[i] << " " << supplies[j] << " " << supplies[k] << " " << supplies[l] << " " << supplies[m] << endl;
-                          break;
-                      }
-                  }
-              }
-          }
+// Helper function for the resupply DP: writes to pick[] the positions of j
+// values among w[lo..hi-1] whose total is t, such a choice being known to
+// exist. The left half's totals going up meet the right half's going down
+// from t at some split of j and t, then each half is solved the same way.
+// Tables span [0, t] only, and a level costs half the one above it.
+void resupplySplit(const long long w[], int n, int lo, int hi, int j, long long t, int pick[]) {
+  if (j == 0) return;
+  if (hi - lo == j) {
+    for (int i = 0; i < j; i++) pick[i] = lo + i;
+    return;
+  }
+  int mid = lo + (hi - lo) / 2;
+  long long words = t / 64 + 1;
+  unsigned long long *left = new unsigned long long[words * (j + 1)];
+  unsigned long long *right = new unsigned long long[words * (j + 1)];
+  resupplyLayers(left, j, t + 1, w, n, lo, mid, 0, true);
+  resupplyLayers(right, j, t + 1, w, n, mid, hi, t, false);
+
+  int split = -1;
+  long long at = 0;
+  for (int a = 0; a <= j && split < 0; a++) {
+    const unsigned long long *l = left + a * words;
+    const unsigned long long *r = right + (j - a) * words;
+    for (long long q = 0; q < words; q++) {
+      unsigned long long x = l[q] & r[q];
+      if (x) {
+        split = a;
+        at = q * 64 + __builtin_ctzll(x);
+        break;
+      }
+    }
+  }
+  delete[] left;
+  delete[] right;
+
+  resupplySplit(w, n, lo, mid, split, at, pick);
+  resupplySplit(w, n, mid, hi, j - split, t - at, pick + split);
+}
+
+// Helper function for resupplyTable: the gcd of the differences of the
+// sorted values v[idx[0..m-1]], 0 if they are all equal
+long long resupplyGcd(const long long v[], const int idx[], int m) {
+  long long g = 0;
+  for (int p = 1; p < m; p++) g = gcdOf(g, v[idx[p]] - v[idx[p - 1]]);
+  return g;
+}
+
+// Helper function for resupplyTable: estimated word updates of the DP when
+// the values v[rest[0..m-1]], congruent modulo g, fill totals up to limit
+// and o outliers are set aside (a pass per number of outliers picked)
+long long resupplyCost(long long limit, long long g, int m, int o, int k) {
+  long long words = ((g > 0) ? limit / g : 0) / 64 + 1;
+  int passes = ((o < k) ? o : k) + 1;
+  return words * k * m * passes;
+}
+
+// Helper function for resupplyPick: splits the sorted values v[] into the
+// rest (rest[0..m-1], all congruent modulo the returned g) and at most
+// RESUPPLY_MAX_OUTLIERS outliers (out[0..o-1], ascending) set aside so
+// that g grows.
+// Each round sets aside the value whose removal leaves the largest gcd, and
+// the split with the cheapest DP over totals up to limit is kept.
+long long resupplyResidues(const long long v[], int n, int k, long long limit,
+                           int rest[], int &m, int out[], int &o) {
+  int *cur = new int[n];
+  long long *pre = new long long[n + 1]; // pre[p]: gcd of the first p differences
+  long long *suf = new long long[n + 1]; // suf[p]: gcd of differences p and later
+  int removed[RESUPPLY_MAX_OUTLIERS];
+  for (int i = 0; i < n; i++) cur[i] = i;
+  int size = n;
+
+  long long bestG = resupplyGcd(v, cur, size);
+  long long bestCost = resupplyCost(limit, bestG, size, 0, k);
+  int bestRounds = 0;
+  for (int round = 1; round <= RESUPPLY_MAX_OUTLIERS && size > 2; round++) {
+    pre[0] = 0;
+    for (int p = 1; p < size; p++) pre[p] = gcdOf(pre[p - 1], v[cur[p]] - v[cur[p - 1]]);
+    suf[size - 1] = 0;
+    for (int p = size - 2; p >= 0; p--) suf[p] = gcdOf(suf[p + 1], v[cur[p + 1]] - v[cur[p]]);
+
+    // Removing position q joins its two differences into one
+    int drop = 0;
+    long long dropG = -1;
+    for (int q = 0; q < size; q++) {
+      long long g;
+      if (q == 0) g = suf[1];
+      else if (q == size - 1) g = pre[size - 2];
+      else g = gcdOf(gcdOf(pre[q - 1], suf[q + 1]), v[cur[q + 1]] - v[cur[q - 1]]);
+      if (g > dropG) {
+        dropG = g;
+        drop = q;
       }
+    }
+    removed[round - 1] = cur[drop];
+    for (int p = drop; p + 1 < size; p++) cur[p] = cur[p + 1];
+    size--;
+
+    long long cost = resupplyCost(limit, dropG, size, round, k);
+    if (cost < bestCost) {
+      bestCost = cost;
+      bestG = dropG;
+      bestRounds = round;
+    }
+  }
+
+  // Rebuild the kept split: the first bestRounds values set aside go out
+  o = bestRounds;
+  for (int i = 0; i < o; i++) {
+    int j = i;
+    for (; j > 0 && out[j - 1] > removed[i]; j--) out[j] = out[j - 1];
+    out[j] = removed[i];
+  }
+  m = 0;
+  for (int i = 0; i < n; i++) {
+    bool isOut = false;
+    for (int j = 0; j < o; j++) isOut = isOut || out[j] == i;
+    if (!isOut) rest[m++] = i;
+  }
+
+  delete[] cur;
+  delete[] pre;
+  delete[] suf;
+  return bestG;
+}
+
+// Fallback for resupplyPick when the search runs out of budget: exact DP
+// over the totals below the best one found so far. With the outliers
+// out[0..o-1] set aside (see resupplyResidues), the other values rest[0..m-1]
+// are all congruent modulo g, so their shifted totals count in steps of g.
+// For every number u of outliers picked, one table holds the totals of
+// k - u of the others, and each choice of u outliers looks up the least
+// total that closes the gap with it. Returns false, doing nothing, when the
+// tables exceed RESUPPLY_MAX_TABLE or RESUPPLY_MAX_WORK.
+bool resupplyTable(ResupplySearch &s, const int rest[], int m, const int out[], int o, long long g) {
+  long long low = s.v[rest[0]];
+
+  // Largest shifted total worth a table row, over every number of outliers
+  long long cost = 0;
+  bool fits = true;
+  for (int u = 0; u <= o && u <= s.k; u++) {
+    int j = s.k - u;
+    if (j > m || j == 0) continue;
+    long long outMin = 0; // the u smallest outliers
+    for (int i = 0; i < u; i++) outMin += s.v[out[i]];
+    long long top = (s.best - 1 - outMin - j * low) / g;
+    if (top < 0) continue;
+    long long words = top / 64 + 1;
+    cost += words * j;
+    fits = fits && words * (j + 1) <= RESUPPLY_MAX_TABLE;
   }
+  if (!fits || cost > RESUPPLY_MAX_WORK / m) return false;
 
-  return (min_total_supply == INT_MAX) ? -1 : min_total_supply;
+  long long *w = new long long[m];
+  for (int i = 0; i < m; i++) w[i] = (s.v[rest[i]] - low) / g;
+  int *pick = new int[s.k];
+
+  for (int u = 0; u <= o && u <= s.k; u++) {
+    int j = s.k - u;
+    if (j > m) continue;
+
+    // Rows of the totals of j of the rest, for this many outliers at most
+    long long outMin = 0;
+    for (int i = 0; i < u; i++) outMin += s.v[out[i]];
+    long long top = (j == 0) ? 0 : (s.best - 1 - outMin - j * low) / g;
+    if (top < 0) continue;
+    long long words = top / 64 + 1;
+    unsigned long long *rows = nullptr;
+    if (j > 0) {
+      rows = new unsigned long long[words * (j + 1)];
+      resupplyLayers(rows, j, top + 1, w, m, 0, m, 0, true);
+    }
+    const unsigned long long *row = (j > 0) ? rows + j * words : nullptr;
+
+    // Every choice of u outliers (bits of mask, lowest outliers first)
+    for (int mask = 0; mask < (1 << o); mask++) {
+      if (__builtin_popcount(mask) != u) continue;
+      long long sumU = 0;
+      for (int i = 0; i < o; i++) if ((mask >> i) & 1) sumU += s.v[out[i]];
+
+      long long t;
+      if (j == 0) {
+        t = (sumU >= s.need) ? 0 : -1;
+      } else {
+        // First set bit of row j from the least total that closes the gap
+        long long from = s.need - sumU - j * low;
+        from = (from <= 0) ? 0 : (from + g - 1) / g;
+        t = -1;
+        for (long long q = from / 64; q < words && t < 0; q++) {
+          unsigned long long x = row[q];
+          if (q == from / 64) x &= ~0ULL << (from % 64);
+          if (x) t = q * 64 + __builtin_ctzll(x);
+        }
+        if (t > top) t = -1;
+      }
+      if (t < 0 || sumU + j * low + t * g >= s.best) continue;
+
+      int c = 0;
+      for (int i = 0; i < o; i++) if ((mask >> i) & 1) s.cur[c++] = out[i];
+      if (j > 0) {
+        resupplySplit(w, m, 0, m, j, t, pick);
+        for (int i = 0; i < j; i++) s.cur[c++] = rest[pick[i]];
+      }
+      recordResupply(s, sumU + j * low + t * g);
+    }
+    delete[] rows;
+  }
+
+  delete[] pick;
+  delete[] w;
+  return true;
+}
+
+// Helper function for resupplyPick: the same search, but its outcome is
+// returned apart from the total, which may itself be negative once the
+// values can be: 1 with the total set, 0 if no choice reaches the
+// shortfall, -1 if the DP would not fit and the bounded search ran out
+// before proving its best total
+int pickResupply(int shortfall, const int supply[], int n, int k, int picked[], int &total) {
+  if (k < 0 || n < 0 || k > n) return 0;
+  if (k == 0) {
+    total = 0;
+    return (shortfall <= 0) ? 1 : 0;
+  }
+
+  int *order = new int[n];
+  for (int i = 0; i < n; i++) order[i] = i;
+  sortIndicesByValue(supply, order, n);
+
+  long long *v = new long long[n];
+  long long *pre = new long long[n + 1];
+  pre[0] = 0;
+  for (int i = 0; i < n; i++) {
+    v[i] = supply[order[i]];
+    pre[i + 1] = pre[i] + v[i];
+  }
+
+  // Every k-value total is congruent to k*v[0] modulo the gcd g of the
+  // differences, which bounds the totals from below
+  long long g = 0;
+  for (int i = 1; i < n; i++) g = gcdOf(g, v[i] - v[0]);
+  if (g == 0) g = 1;
+
+  int *rest = nullptr; // the split, once made
+  int out[RESUPPLY_MAX_OUTLIERS];
+  int m = 0, o = 0;
+  int *cur = new int[k];
+  int *bestPick = new int[k];
+  // The k largest values are the first candidate, if they reach the
+  // shortfall at all. Branch and bound next. If it stalls, set a few
+  // outliers aside so that the rest share a larger gcd, which bounds the
+  // totals far better, and search again. If that stalls too, bound the
+  // totals by the best one found so far and finish with the DP table. Only
+  // when the table would be too large does the search go on, for a fixed
+  // budget; if that runs out too, its best total is not known to be the least.
+  ResupplySearch s = {v, pre, n, k, shortfall, 0, LLONG_MAX, cur, bestPick,
+                      RESUPPLY_FIRST_STEPS, out, 0, g, v[0]};
+  s.floor = resupplyBound(s, 0, k, 0);
+  if (pre[n] - pre[n - k] >= shortfall) {
+    for (int i = 0; i < k; i++) cur[i] = n - k + i;
+    recordResupply(s, pre[n] - pre[n - k]);
+  }
+  if (s.best != LLONG_MAX) resupplySearch(s, 0, 0, 0);
+  if (s.budget == 0 && s.best != s.floor) {
+    rest = new int[n];
+    s.g = resupplyResidues(v, n, k, s.best - k * v[0] - 1, rest, m, out, o);
+    if (s.g == 0) s.g = 1;
+    s.o = o;
+    s.low = v[rest[0]];
+    long long floor = resupplyBound(s, 0, k, 0);
+    if (floor > s.floor) s.floor = floor;
+    s.budget = 1 << 22;
+    resupplySearch(s, 0, 0, 0);
+  }
+  int result = 1;
+  if (s.budget == 0 && s.best != s.floor && !resupplyTable(s, rest, m, out, o, s.g)) {
+    s.budget = RESUPPLY_MAX_STEPS;
+    resupplySearch(s, 0, 0, 0);
+    if (s.budget == 0 && s.best != s.floor) result = -1;
+  }
+
+  if (s.best == LLONG_MAX) {
+    result = 0;
+  } else if (result == 1) {
+    total = (int)s.best;
+    if (picked != nullptr) {
+      for (int i = 0; i < k; i++) picked[i] = order[bestPick[i]];
+    }
+  }
+
+  delete[] order;
+  delete[] v;
+  delete[] pre;
+  delete[] rest;
+  delete[] cur;
+  delete[] bestPick;
+  return result;
+}
+
+int resupplyPick(int shortfall, const int supply[], int n, int k, int picked[]) {
+  int total;
+  int result = pickResupply(shortfall, supply, n, k, picked, total);
+  return (result == 1) ? total : (result == 0) ? -1 : -2;
+}
+
+ResupplyIndex::ResupplyIndex(const int supply[], int n, int k)
+  : sums(nullptr), count(0), values(nullptr), n(n), k(k)
+{
+  init(supply);
+}
+
+ResupplyIndex::ResupplyIndex(int supply[5][5])
+  : sums(nullptr), count(0), values(nullptr), n(25), k(5)
+{
+  init(&supply[0][0]);
+}
+
+ResupplyIndex::~ResupplyIndex() {
+  delete[] sums;
+  delete[] values;
+}
+
+void ResupplyIndex::init(const int supply[]) {
+  if (k < 0 || n < 0 || k > n) return; // no totals at all
+  if (k == 0) {
+    sums = new int[1];
+    sums[0] = 0;
+    count = 1;
+    return;
+  }
+
+  int *order = new int[n];
+  for (int i = 0; i < n; i++) order[i] = i;
+  sortIndicesByValue(supply, order, n);
+
+  // Shifted totals are multiples of the gcd g of the differences: tabulate
+  // them in steps of g
+  long long low = supply[order[0]];
+  long long g = 0;
+  for (int i = 1; i < n; i++) g = gcdOf(g, supply[order[i]] - low);
+  if (g == 0) g = 1;
+  long long *w = new long long[n];
+  for (int i = 0; i < n; i++) w[i] = (supply[order[i]] - low) / g;
+  long long limit = 0; // largest shifted total: the k largest values
+  for (int i = n - k; i < n; i++) limit += w[i];
+  long long width = limit + 1;
+
+  long long words = limit / 64 + 1;
+
+  if (width > RESUPPLY_MAX_TABLE || words * (k + 1) > RESUPPLY_MAX_TABLE ||
+      words * k > RESUPPLY_MAX_WORK / n) {
+    // Too many possible totals to tabulate: answer each query by search
+    values = new int[n];
+    for (int i = 0; i < n; i++) values[i] = supply[i];
+    delete[] w;
+    delete[] order;
+    return;
+  }
+
+  // Row j of reach: the shifted totals of j of the values
+  unsigned long long *reach = new unsigned long long[words * (k + 1)];
+  resupplyLayers(reach, k, width, w, n, 0, n, 0, true);
+
+  // Row k read in order is already sorted and free of duplicates
+  const unsigned long long *row = reach + k * words;
+  for (long long t = 0; t < width; t++) count += (int)((row[t / 64] >> (t % 64)) & 1ULL);
+  sums = new int[count];
+  int idx = 0;
+  for (long long t = 0; t < width; t++) {
+    if ((row[t / 64] >> (t % 64)) & 1ULL) sums[idx++] = (int)(k * low + t * g);
+  }
+
+  delete[] reach;
+  delete[] w;
+  delete[] order;
+}
+
+int ResupplyIndex::query(int shortfall) const {
+  if (values != nullptr) return resupplyPick(shortfall, values, n, k, nullptr);
+
+  // First total >= shortfall
+  int lo = 0, hi = count;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (sums[mid] >= shortfall) hi = mid;
+    else lo = mid + 1;
+  }
+  return (lo < count) ? sums[lo] : -1;
+}
+
+void ResupplyIndex::queryBatch(const int shortfalls[], int m, int results[]) const {
+  for (int i = 0; i < m; i++) {
+    results[i] = query(shortfalls[i]);
+  }
+}
+
+int ResupplyIndex::size() const {
+  return count;
+}
+
+// A subproblem of ResupplyPlanner: plans that contain cells[0..nIn-1] and
+// none of out[0..nOut-1]. cells[] holds its cheapest plan once solved.
+struct ResupplyPlanner::Node {
+  int total;
+  int *cells;
+  int nIn;
+  int *out;
+  int nOut;
+};
+
+ResupplyPlanner::ResupplyPlanner(const int supply[], int rows, int cols, int k, int shortfall)
+  : rows(rows), cols(cols), n(rows * cols), k(k), shortfall(shortfall), complete(true)
+{
+  init(supply);
+}
+
+ResupplyPlanner::ResupplyPlanner(int supply[5][5], int shortfall)
+  : rows(5), cols(5), n(25), k(5), shortfall(shortfall), complete(true)
+{
+  init(&supply[0][0]);
+}
+
+ResupplyPlanner::~ResupplyPlanner() {
+  for (int i = 0; i < heapSize; i++) {
+    delete[] heap[i]->cells;
+    delete[] heap[i]->out;
+    delete heap[i];
+  }
+  delete[] heap;
+  delete[] supply;
+  delete[] vals;
+  delete[] cellOf;
+  delete[] picks;
+  delete[] banned;
+}
+
+void ResupplyPlanner::init(const int grid[]) {
+  if (n < 0) n = 0;
+  supply = new int[n];
+  for (int i = 0; i < n; i++) supply[i] = grid[i];
+
+  heapSize = 0;
+  heapCap = 16;
+  heap = new Node*[heapCap];
+
+  int kk = (k > 0) ? k : 0;
+  vals = new int[n];
+  cellOf = new int[n];
+  picks = new int[kk];
+  banned = new unsigned char[n];
+  memset(banned, 0, n);
+
+  if (k < 0 || k > n) return; // no plan at all
+
+  Node *root = new Node;
+  root->cells = new int[kk];
+  root->nIn = 0;
+  root->out = nullptr;
+  root->nOut = 0;
+  if (solve(root)) {
+    push(root);
+  } else {
+    delete[] root->cells;
+    delete root;
+  }
+}
+
+bool ResupplyPlanner::solve(Node *node) {
+  int need = shortfall, sumIn = 0;
+  for (int i = 0; i < node->nIn; i++) {
+    banned[node->cells[i]] = 1;
+    sumIn += supply[node->cells[i]];
+  }
+  for (int i = 0; i < node->nOut; i++) banned[node->out[i]] = 1;
+  need -= sumIn;
+
+  int m = 0;
+  for (int c = 0; c < n; c++) {
+    if (!banned[c]) {
+      vals[m] = supply[c];
+      cellOf[m++] = c;
+    }
+  }
+  for (int i = 0; i < node->nIn; i++) banned[node->cells[i]] = 0;
+  for (int i = 0; i < node->nOut; i++) banned[node->out[i]] = 0;
+
+  int r = k - node->nIn;
+  int rest;
+  int result = pickResupply(need, vals, m, r, picks, rest);
+  if (result == -1) complete = false; // its plans cannot be listed in order
+  if (result != 1) return false;
+
+  for (int i = 0; i < r; i++) node->cells[node->nIn + i] = cellOf[picks[i]];
+  node->total = sumIn + rest;
+  return true;
+}
+
+void ResupplyPlanner::push(Node *node) {
+  if (heapSize == heapCap) {
+    Node **bigger = new Node*[heapCap * 2];
+    for (int i = 0; i < heapSize; i++) bigger[i] = heap[i];
+    delete[] heap;
+    heap = bigger;
+    heapCap *= 2;
+  }
+  int i = heapSize++;
+  while (i > 0 && heap[(i - 1) / 2]->total > node->total) {
+    heap[i] = heap[(i - 1) / 2];
+    i = (i - 1) / 2;
+  }
+  heap[i] = node;
+}
+
+ResupplyPlanner::Node *ResupplyPlanner::pop() {
+  Node *top = heap[0];
+  Node *last = heap[--heapSize];
+  int i = 0;
+  while (2 * i + 1 < heapSize) {
+    int child = 2 * i + 1;
+    if (child + 1 < heapSize && heap[child + 1]->total < heap[child]->total) child++;
+    if (last->total <= heap[child]->total) break;
+    heap[i] = heap[child];
+    i = child;
+  }
+  heap[i] = last;
+  return top;
+}
+
+bool ResupplyPlanner::exact() const {
+  return complete;
+}
+
+bool ResupplyPlanner::next(int &total, int row[], int col[]) {
+  if (heapSize == 0) return false;
+  Node *node = pop();
+
+  // Report the plan with its cells in row-major order
+  total = node->total;
+  for (int i = 0; i < k; i++) {
+    int c = node->cells[i], j = i;
+    while (j > 0 && row[j - 1] * cols + col[j - 1] > c) {
+      row[j] = row[j - 1];
+      col[j] = col[j - 1];
+      j--;
+    }
+    row[j] = c / cols;
+    col[j] = c % cols;
+  }
+
+  // Split the rest of this subproblem: the i-th child keeps the first i free
+  // cells of the plan and excludes the next one
+  for (int i = node->nIn; i < k; i++) {
+    Node *child = new Node;
+    child->cells = new int[k];
+    child->nIn = i;
+    for (int j = 0; j < i; j++) child->cells[j] = node->cells[j];
+    child->nOut = node->nOut + 1;
+    child->out = new int[child->nOut];
+    for (int j = 0; j < node->nOut; j++) child->out[j] = node->out[j];
+    child->out[node->nOut] = node->cells[i];
+
+    if (solve(child)) {
+      push(child);
+    } else {
+      delete[] child->cells;
+      delete[] child->out;
+      delete child;
+    }
+  }
+
+  delete[] node->cells;
+  delete[] node->out;
+  delete node;
+  return true;
+}
+
+// Task 5
+int resupply(int shortfall, int supply[5][5])
+{
+  // Chọn 5 ô có tổng nhỏ nhất nhưng vẫn >= shortfall
+  return resupplyFixed<5, 5, 5>(shortfall, supply);
 }
 
 ////////////////////////////////////////////////
@@ -23,22 +23,383 @@ bool readFile(
 /// DO NOT modify any parameters in the functions.
 ////////////////////////////////////////////////////////////////////////
 
+// Rounding of planAttack and manageLogistics. DOUBLE_ARITHMETIC (the
+// default) evaluates the original double expressions in their original
+// order: planAttack still subtracts the battlefield cell by cell.
+// EXACT_ARITHMETIC evaluates the formulas as exact integer fractions;
+// VERIFY_ARITHMETIC returns the exact result and counts every call where
+// the double one differs. EXACT is opt-in: where a score is exactly an
+// integer, the drifting double sum often rounds it one higher, so the two
+// modes give different answers for the same input.
+// setArithmeticMode also resets that count.
+enum ArithmeticMode { EXACT_ARITHMETIC, DOUBLE_ARITHMETIC, VERIFY_ARITHMETIC };
+void setArithmeticMode(ArithmeticMode mode);
+ArithmeticMode arithmeticMode();
+long long arithmeticMismatches();
+
+// Task 0 (archive): one 5-line scenario in the readFile format
+struct Scenario {
+  int LF1[17], LF2[17];
+  int EXP1, EXP2;
+  int T1, T2;
+  int E;
+  int error;  // 0 if the scenario parsed, else the line (1..5) that failed
+};
+
+// Reads every scenario of a file that holds them back to back, in one pass
+// and with no limit on line length. Values are clamped as in readFile.
+// Returns a new[] array of count scenarios (release it with delete[]), or
+// nullptr if the file cannot be opened.
+Scenario *readScenarios(const string &filename, int &count);
+Scenario *parseScenarios(const char data[], long long size, int &count);
+
+// One scenario from its five lines [line[i], lineEnd[i]), newline excluded.
+// Returns 0, or the line (1..5) that failed; sc.error is left to the caller.
+int parseScenario(const char *line[], const char *lineEnd[], Scenario &sc);
+
 // Task 1: Gather Forces
 int gatherForces(int LF1[], int LF2[]);
 
+// Task 1 (batch): LF of n records stored as 17 columns of n values each,
+// i.e. LF1[i*n + r] is entry i of record r. The inputs are clamped on the
+// fly and left unchanged. gatherForcesRange only fills result[begin..end-1],
+// so large batches can be split into chunks across workers.
+void gatherForcesBatch(const int LF1[], const int LF2[], int n, int result[]);
+void gatherForcesRange(const int LF1[], const int LF2[], int n, int begin, int end, int result[]);
+
 // Task 2: Deception Strategy
 string determineRightTarget(const string &target);
 string decodeTarget(const string &message, int EXP1, int EXP2);
 
+// Task 2 (scanner): determineRightTarget without any allocation. Returns the
+// target id 3..7, 0..2 for a decoy, or -1 for INVALID; targetName() maps
+// the id to the string determineRightTarget returns.
+int determineRightTargetId(const char target[], long long len);
+const char *targetName(int id);
+
+// Task 2 (bulk): one message per line in, one target name per line out.
+// Returns the number of messages.
+long long determineRightTargets(const char messages[], long long len, ostream &out);
+bool determineRightTargetsFile(const string &inFile, const string &outFile);
+
+// Task 2.2 (scanner): decodeTarget in one pass with no allocation. Returns
+// the index in validTargets of the decoded target, or -1 for INVALID.
+int decodeTargetId(const char message[], long long len, int EXP1, int EXP2);
+
+// Task 2.2 (shift search): for a message whose EXP1/EXP2 are unknown, lists
+// every validTargets index it decodes to and how: a Caesar shift 0..25, or
+// REVERSED_SHIFT for the message read backwards. target[] and shift[] need
+// room for MAX_TARGET_MATCHES entries. Returns the number of matches.
+const int REVERSED_SHIFT = -1;
+const int MAX_TARGET_MATCHES = 10;
+int searchTargets(const char message[], long long len, int target[], int shift[]);
+
+// Task 2 (cache): remembers the answers of determineRightTarget and
+// decodeTarget for messages seen before. A key is the message bytes plus
+// how it is read: the Caesar shift or REVERSED_SHIFT that EXP1/EXP2 select,
+// so EXP pairs with the same shift share one entry. Entries are spread over
+// `shards` LRU lists of fixed size, allocated once, so memory stays capped;
+// messages longer than DECODE_CACHE_KEY bytes are answered without caching.
+// Each shard has its own spin lock, so threads may share one cache.
+const int DECODE_CACHE_KEY = 48;
+
+class DecodeCache {
+public:
+  DecodeCache(int capacity, int shards);
+  ~DecodeCache();
+
+  string determineRightTarget(const string &target);
+  string decodeTarget(const string &message, int EXP1, int EXP2);
+  int determineRightTargetId(const char target[], long long len);
+  int decodeTargetId(const char message[], long long len, int EXP1, int EXP2);
+
+  long long hits() const;
+  long long misses() const;
+
+private:
+  struct Entry;
+  struct Shard;
+
+  Shard *shards;
+  int shardCount;
+  long long hitCount, missCount;
+
+  DecodeCache(const DecodeCache &);
+  DecodeCache &operator=(const DecodeCache &);
+  int lookup(const char key[], long long len, int code, int EXP1, int EXP2);
+};
+
 // Task 3: Logistics Management
 void manageLogistics(int LF1, int LF2, int EXP1, int EXP2, int &T1, int &T2, int E);
 
+// Task 3 (batch): manageLogistics on n records stored as parallel arrays;
+// T1[] and T2[] are updated in place with exactly the scalar results.
+void manageLogisticsBatch(const int LF1[], const int LF2[], const int EXP1[], const int EXP2[],
+                          int T1[], int T2[], const int E[], int n);
+
 // Task 4: Attack Planning
 int planAttack(int LF1, int LF2, int EXP1, int EXP2, int T1, int T2, int battleField[10][10]);
 
+// Task 4 (general): same score for a rows x cols battlefield stored row-major
+int planAttackGrid(int LF1, int LF2, int EXP1, int EXP2, int T1, int T2,
+                   const int battleField[], int rows, int cols);
+
+// Helpers of planAttackGrid, shared with planAttackFixed
+long long attackBase(int LF1, int LF2, int EXP1, int EXP2, int T1, int T2);
+int attackScoreCells(long long base, const int battleField[], int rows, int cols);
+int attackScoreExact(long long base, long long evenSum, long long oddSum);
+double attackDrift(long long base, long long absSum, long long count);
+bool attackExactMatches(long long evenSum, long long oddSum, double drift);
+int attackScore(long long base, long long evenSum, long long oddSum,
+                const int battleField[], int rows, int cols);
+
+// Task 4 (fixed size): planAttackGrid for an R x C battlefield whose size is
+// known at compile time, so both loops unroll. planAttack uses <10, 10>.
+template<int R, int C>
+int planAttackFixed(int LF1, int LF2, int EXP1, int EXP2, int T1, int T2, const int battleField[R][C])
+{
+  long long base = attackBase(LF1, LF2, EXP1, EXP2, T1, T2);
+
+  // Rows in pairs: two independent sums per column, no branch on the row
+  long long evenSum = 0, oddSum = 0, absSum = 0;
+  for (int i = 0; i + 1 < R; i += 2) {
+    for (int j = 0; j < C; j++) {
+      long long e = battleField[i][j], o = battleField[i + 1][j];
+      evenSum += e;
+      oddSum += o;
+      absSum += (e < 0 ? -e : e) + (o < 0 ? -o : o);
+    }
+  }
+  if (R % 2 == 1) {
+    for (int j = 0; j < C; j++) {
+      long long e = battleField[R - 1][j];
+      evenSum += e;
+      absSum += e < 0 ? -e : e;
+    }
+  }
+  if (arithmeticMode() != DOUBLE_ARITHMETIC) {
+    return attackScore(base, evenSum, oddSum, &battleField[0][0], R, C);
+  }
+  if (attackExactMatches(evenSum, oddSum, attackDrift(base, absSum, (long long)R * C))) {
+    return attackScoreExact(base, evenSum, oddSum);
+  }
+
+  // attackScoreCells with the bounds known
+  double S = base;
+  for (int i = 0; i < R; i++) {
+    if (i % 2 == 0) {
+      for (int j = 0; j < C; j++) S -= battleField[i][j]*2.0/3.0;
+    }
+    else {
+      for (int j = 0; j < C; j++) S -= battleField[i][j]*3.0/2.0;
+    }
+  }
+  S = ceil(S);
+  if (S < INT_MIN) return INT_MIN;
+  if (S > INT_MAX) return INT_MAX;
+  return S;
+}
+
+// Task 4 (incremental): keeps the even-row and odd-row totals of a
+// battlefield so that a cell change updates the score in O(1).
+// score() always equals planAttackGrid on the current cells. With the
+// default DOUBLE_ARITHMETIC it is O(1) too, except that it replays the
+// per-cell sum when the score is exactly an integer (about one call in
+// six) or the cells are too large to bound its rounding.
+class BattlefieldScore {
+public:
+  BattlefieldScore(int LF1, int LF2, int EXP1, int EXP2, int T1, int T2,
+                   const int battleField[], int rows, int cols);
+  BattlefieldScore(int LF1, int LF2, int EXP1, int EXP2, int T1, int T2,
+                   int battleField[10][10]);
+  ~BattlefieldScore();
+
+  // Out-of-range cells are ignored
+  void setCell(int r, int c, int v);
+  int getCell(int r, int c) const;
+
+  int score() const;
+
+private:
+  int *cells;   // row-major copy of the battlefield
+  int rows, cols;
+  long long base, evenSum, oddSum;
+  long long absSum;  // total of |cell|, bounds the rounding of the double sum
+
+  BattlefieldScore(const BattlefieldScore &);
+  BattlefieldScore &operator=(const BattlefieldScore &);
+  void init(const int battleField[]);
+};
+
 // Task 5: Resupply
 int resupply(int shortfall, int supply[5][5]);
 
+// Task 5 (general): choose exactly k of the n values in supply[] so that their
+// total is the smallest one that is >= shortfall. The indices of the chosen
+// values are written to picked[] (k entries, may be nullptr).
+// Returns the total, or -1 if no choice of k values reaches the shortfall.
+// The total is always the least one. Only when n, k and the spread of the
+// values are so large that neither the DP behind the search nor a bounded
+// search can settle it does it return -2 instead.
+int resupplyPick(int shortfall, const int supply[], int n, int k, int picked[]);
+
+long long gcdOf(long long a, long long b);
+
+// One level of the fixed-size resupply search over N sorted values v[] with
+// prefix sums pre[], R picks left (the same bounds as resupplyPick's search).
+// floor is a lower bound on any answer, so reaching it ends the search.
+template<int N, int R>
+struct ResupplyStep {
+  static void search(const long long v[], const long long pre[], int start, long long sum,
+                     long long need, long long floor, long long &best) {
+    if (sum + pre[N] - pre[N - R] < need) return;
+    for (int i = start; i <= N - R; i++) {
+      if (i > start && v[i] == v[i - 1]) continue;
+      long long low = sum + pre[i + R] - pre[i];
+      if (low >= best) break;
+      if (low >= need) {
+        best = low;
+        break;
+      }
+      ResupplyStep<N, R - 1>::search(v, pre, i + 1, sum + v[i], need, floor, best);
+      if (best == floor) return;
+    }
+  }
+};
+
+// Last two picks: two pointers
+template<int N>
+struct ResupplyStep<N, 2> {
+  static void search(const long long v[], const long long /*pre*/[], int start, long long sum,
+                     long long need, long long floor, long long &best) {
+    int i = start, j = N - 1;
+    while (i < j) {
+      long long total = sum + v[i] + v[j];
+      if (total >= need) {
+        if (total < best) {
+          best = total;
+          if (best == floor) return;
+        }
+        j--;
+      } else {
+        i++;
+      }
+    }
+  }
+};
+
+// Last pick: binary search
+template<int N>
+struct ResupplyStep<N, 1> {
+  static void search(const long long v[], const long long /*pre*/[], int start, long long sum,
+                     long long need, long long floor, long long &best) {
+    int lo = start, hi = N;
+    while (lo < hi) {
+      int mid = lo + (hi - lo) / 2;
+      if (sum + v[mid] >= need) hi = mid;
+      else lo = mid + 1;
+    }
+    if (lo < N && sum + v[lo] < best) best = sum + v[lo];
+  }
+};
+
+// Task 5 (fixed size): resupplyPick's total for K values out of an R x C grid
+// known at compile time. Every buffer is on the stack and each pick is its
+// own search level, so nothing is allocated. Meant for small grids (it has no
+// DP fallback); resupply uses <5, 5, 5>.
+template<int R, int C, int K>
+int resupplyFixed(int shortfall, const int supply[R][C])
+{
+  const int N = R * C;
+  static_assert(K >= 1 && K <= N, "resupplyFixed needs 1 <= K <= R*C");
+
+  // Insertion sort, N is small
+  long long v[N], pre[N + 1];
+  for (int i = 0; i < N; i++) {
+    long long x = supply[i / C][i % C];
+    int j = i;
+    for (; j > 0 && v[j - 1] > x; j--) v[j] = v[j - 1];
+    v[j] = x;
+  }
+  pre[0] = 0;
+  for (int i = 0; i < N; i++) pre[i + 1] = pre[i] + v[i];
+
+  // Same gcd lower bound as resupplyPick
+  long long g = 0;
+  for (int i = 1; i < N; i++) g = gcdOf(g, v[i] - v[0]);
+  long long floor = shortfall;
+  if (g > 0) floor += (((K * v[0] - floor) % g) + g) % g;
+
+  long long best = LLONG_MAX;
+  ResupplyStep<N, K>::search(v, pre, 0, 0, shortfall, floor, best);
+  return (best == LLONG_MAX) ? -1 : (int)best;
+}
+
+// Task 5 (many queries): every distinct total of exactly k supply values,
+// computed once and kept sorted, so that each shortfall is answered by a
+// binary search. query() returns the same value as resupplyPick, -2 included.
+class ResupplyIndex {
+public:
+  ResupplyIndex(const int supply[], int n, int k);
+  explicit ResupplyIndex(int supply[5][5]);
+  ~ResupplyIndex();
+
+  int query(int shortfall) const;
+  void queryBatch(const int shortfalls[], int m, int results[]) const;
+
+  // Number of distinct totals held
+  int size() const;
+
+private:
+  int *sums;    // distinct totals, ascending
+  int count;
+  int *values;  // copy of the supply, kept only when the totals are too many
+  int n, k;     // to tabulate; queries then fall back to resupplyPick
+
+  ResupplyIndex(const ResupplyIndex &);
+  ResupplyIndex &operator=(const ResupplyIndex &);
+  void init(const int supply[]);
+};
+
+// Task 5 (alternatives): lists the plans of k cells whose total reaches the
+// shortfall, cheapest first. Each plan split off the frontier is solved with
+// resupplyPick on demand, so only the plans actually requested are built.
+class ResupplyPlanner {
+public:
+  ResupplyPlanner(const int supply[], int rows, int cols, int k, int shortfall);
+  ResupplyPlanner(int supply[5][5], int shortfall);
+  ~ResupplyPlanner();
+
+  // Writes the next plan's total and the row/col of its k cells (ascending
+  // row-major order). Returns false once every plan has been listed.
+  bool next(int &total, int row[], int col[]);
+
+  // False once a subproblem was dropped because resupplyPick returned -2
+  // for it: the plans listed may then miss some, though in order
+  bool exact() const;
+
+private:
+  struct Node;
+
+  int *supply;     // row-major copy of the grid
+  int rows, cols, n, k;
+  int shortfall;
+  bool complete;   // see exact()
+
+  Node **heap;     // frontier of subproblems, min-heap by total
+  int heapSize, heapCap;
+
+  int *vals, *cellOf, *picks; // scratch for solve()
+  unsigned char *banned;
+
+  ResupplyPlanner(const ResupplyPlanner &);
+  ResupplyPlanner &operator=(const ResupplyPlanner &);
+  void init(const int grid[]);
+  bool solve(Node *node);
+  void push(Node *node);
+  Node *pop();
+};
+
 ////////////////////////////////////////////////
 /// END OF STUDENT'S ANSWER
 ////////////////////////////////////////////////
@@ -0,0 +1,298 @@
+/*
+ * Scenario pipeline driver for Assignment 1.
+ *
+ * Streams a scenario archive through the Task 1-5 functions on a fixed pool
+ * of worker threads and writes one result line per scenario, in input order.
+ * This is a tool built on top of the assignment, not part of it, so unlike
+ * tay_nguyen_campaign.cpp it uses the thread library.
+ *
+ * Usage: tnc_driver <archive> <output> [threads]
+ *
+ * Archive format: scenarios back to back, 21 lines each. Lines starting
+ * with '#' are skipped wherever they appear. Blank lines are not, since an
+ * empty LF list is a valid line; only those after the last scenario are.
+ *   1-5    the readFile input: LF1 list, LF2 list, "EXP1 EXP2", "T1 T2", "E"
+ *   6-15   battlefield, one row of 10 integers per line
+ *   16     resupply shortfall
+ *   17-21  supply grid, one row of 5 integers per line
+ * Integers on a grid line are separated by spaces and/or commas.
+ *
+ * Output: one line per scenario, numbered from 0 in archive order
+ *   <index> <forces> <T1> <T2> <attack> <resupply>
+ * where forces is gatherForces(LF1, LF2); T1/T2 are the supplies after
+ * manageLogistics; attack is planAttack on those supplies; resupply is
+ * resupply(shortfall, supply). manageLogistics and planAttack get each
+ * side's own weighted strength (gatherForces of that side alone) as LF1/LF2.
+ * A scenario that does not parse gives
+ *   <index> error <line>
+ * with line the 1-based line of the record (1..21) that failed.
+ */
+
+#include "tay_nguyen_campaign.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+const int RECORD_LINES = 21;
+const int FIELD_ROWS = 10, FIELD_COLS = 10;
+const int SUPPLY_ROWS = 5, SUPPLY_COLS = 5;
+const int BATCH_SIZE = 256;       // scenarios handed to a worker at a time
+const int BATCHES_PER_THREAD = 4; // batches in flight per worker
+
+struct Record {
+  Scenario sc;
+  int battleField[FIELD_ROWS][FIELD_COLS];
+  int shortfall;
+  int supply[SUPPLY_ROWS][SUPPLY_COLS];
+  int error; // 0, or the line of the record that failed
+};
+
+// Raw lines of up to BATCH_SIZE records; the workers parse them
+struct Batch {
+  long long seq;
+  long long firstIndex;
+  int count;             // records in the batch
+  int partial;           // lines of the last record if the archive ended inside it
+  vector<string> lines;  // RECORD_LINES per record
+  string output;
+};
+
+// Fixed-capacity FIFO shared by threads. pop() returns false once the queue
+// is closed and drained.
+class BoundedQueue {
+public:
+  explicit BoundedQueue(size_t capacity) : capacity(capacity), closed(false) {}
+
+  void push(Batch *batch) {
+    unique_lock<mutex> lock(m);
+    notFull.wait(lock, [this] { return items.size() < capacity; });
+    items.push_back(batch);
+    notEmpty.notify_one();
+  }
+
+  bool pop(Batch *&batch) {
+    unique_lock<mutex> lock(m);
+    notEmpty.wait(lock, [this] { return !items.empty() || closed; });
+    if (items.empty()) return false;
+    batch = items.front();
+    items.pop_front();
+    notFull.notify_one();
+    return true;
+  }
+
+  void close() {
+    lock_guard<mutex> lock(m);
+    closed = true;
+    notEmpty.notify_all();
+  }
+
+private:
+  size_t capacity;
+  bool closed;
+  deque<Batch *> items;
+  mutex m;
+  condition_variable notEmpty, notFull;
+};
+
+// Helper function: exactly n integers separated by spaces and/or commas
+bool parseInts(const string &line, int out[], int n) {
+  const char *p = line.c_str();
+  for (int i = 0; i < n; i++) {
+    while (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r') p++;
+    char *end;
+    long v = strtol(p, &end, 10);
+    if (end == p || v < INT_MIN || v > INT_MAX) return false;
+    out[i] = (int)v;
+    p = end;
+  }
+  while (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r') p++;
+  return *p == '\0';
+}
+
+// Helper function: fills rec from the 21 lines of one record
+void parseRecord(const string lines[], Record &rec) {
+  const char *line[5], *lineEnd[5];
+  for (int i = 0; i < 5; i++) {
+    line[i] = lines[i].data();
+    lineEnd[i] = lines[i].data() + lines[i].size();
+  }
+  rec.error = parseScenario(line, lineEnd, rec.sc);
+  if (rec.error != 0) return;
+
+  for (int i = 0; i < FIELD_ROWS; i++) {
+    if (!parseInts(lines[5 + i], rec.battleField[i], FIELD_COLS)) {
+      rec.error = 6 + i;
+      return;
+    }
+  }
+  if (!parseInts(lines[15], &rec.shortfall, 1)) {
+    rec.error = 16;
+    return;
+  }
+  for (int i = 0; i < SUPPLY_ROWS; i++) {
+    if (!parseInts(lines[16 + i], rec.supply[i], SUPPLY_COLS)) {
+      rec.error = 17 + i;
+      return;
+    }
+  }
+}
+
+// Helper function: parses every record of the batch, runs Tasks 1, 3, 4
+// and 5 on it and renders the output lines
+void processBatch(Batch &batch) {
+  static const int NONE[17] = {0};
+  string &out = batch.output;
+  char buf[128];
+  Record rec;
+  for (int i = 0; i < batch.count; i++) {
+    long long index = batch.firstIndex + i;
+    if (batch.partial != 0 && i == batch.count - 1) {
+      rec.error = batch.partial + 1; // the archive ended inside this record
+    } else {
+      parseRecord(&batch.lines[(size_t)i * RECORD_LINES], rec);
+    }
+    if (rec.error != 0) {
+      snprintf(buf, sizeof(buf), "%lld error %d\n", index, rec.error);
+      out += buf;
+      continue;
+    }
+
+    Scenario &sc = rec.sc;
+    int zero[17];
+    memcpy(zero, NONE, sizeof(zero));
+    int side1 = gatherForces(sc.LF1, zero);
+    int side2 = gatherForces(zero, sc.LF2);
+    int forces = gatherForces(sc.LF1, sc.LF2);
+
+    int T1 = sc.T1, T2 = sc.T2;
+    manageLogistics(side1, side2, sc.EXP1, sc.EXP2, T1, T2, sc.E);
+    int attack = planAttack(side1, side2, sc.EXP1, sc.EXP2, T1, T2, rec.battleField);
+    int supplied = resupply(rec.shortfall, rec.supply);
+
+    snprintf(buf, sizeof(buf), "%lld %d %d %d %d %d\n", index, forces, T1, T2, attack, supplied);
+    out += buf;
+  }
+}
+
+// Writes finished batches in sequence order; batches that finish early wait
+// in pending until their turn
+class OrderedWriter {
+public:
+  OrderedWriter(ostream &out, long long window) : out(out), window(window), next(0) {}
+
+  // Blocks the reader while `window` batches are already in flight
+  void reserve(long long seq) {
+    unique_lock<mutex> lock(m);
+    room.wait(lock, [&] { return seq - next < window; });
+  }
+
+  void finish(Batch *batch) {
+    lock_guard<mutex> lock(m);
+    pending[batch->seq] = batch;
+    map<long long, Batch *>::iterator it;
+    while ((it = pending.find(next)) != pending.end()) {
+      out << it->second->output;
+      delete it->second;
+      pending.erase(it);
+      next++;
+    }
+    room.notify_all();
+  }
+
+private:
+  ostream &out;
+  long long window;
+  long long next;
+  map<long long, Batch *> pending;
+  mutex m;
+  condition_variable room;
+};
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    cerr << "Usage: " << argv[0] << " <archive> <output> [threads]" << endl;
+    return 2;
+  }
+  int threads = (argc > 3) ? atoi(argv[3]) : (int)thread::hardware_concurrency();
+  if (threads < 1) threads = 1;
+
+  ifstream in(argv[1]);
+  if (!in.is_open()) {
+    cerr << "Error: cannot open " << argv[1] << endl;
+    return 1;
+  }
+  ofstream out(argv[2]);
+  if (!out.is_open()) {
+    cerr << "Error: cannot write " << argv[2] << endl;
+    return 1;
+  }
+
+  long long window = (long long)threads * BATCHES_PER_THREAD;
+  BoundedQueue work(window);
+  OrderedWriter writer(out, window);
+
+  vector<thread> pool;
+  for (int t = 0; t < threads; t++) {
+    pool.push_back(thread([&] {
+      Batch *batch;
+      while (work.pop(batch)) {
+        processBatch(*batch);
+        writer.finish(batch);
+      }
+    }));
+  }
+
+  // The reader streams the archive line by line and cuts it into batches of
+  // raw lines
+  string line;
+  int got = 0;          // lines of the current record so far
+  bool blankTail = true; // every one of them is blank
+  long long scenarios = 0, seq = 0;
+  Batch *batch = nullptr;
+  while (getline(in, line)) {
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first != string::npos && line[first] == '#') continue;
+    if (batch == nullptr) {
+      writer.reserve(seq);
+      batch = new Batch;
+      batch->seq = seq++;
+      batch->firstIndex = scenarios;
+      batch->count = 0;
+      batch->partial = 0;
+      batch->lines.reserve((size_t)BATCH_SIZE * RECORD_LINES);
+    }
+    batch->lines.push_back(line);
+    if (got == 0) blankTail = true;
+    if (first != string::npos) blankTail = false;
+    if (++got == RECORD_LINES) {
+      got = 0;
+      batch->count++;
+      scenarios++;
+      if (batch->count == BATCH_SIZE) {
+        work.push(batch);
+        batch = nullptr;
+      }
+    }
+  }
+  if (got > 0 && !blankTail) {
+    batch->count++;
+    batch->partial = got;
+    scenarios++;
+  }
+  // Its sequence number is taken, so even an empty batch goes through
+  if (batch != nullptr) work.push(batch);
+  work.close();
+  for (size_t t = 0; t < pool.size(); t++) pool[t].join();
+
+  out.close();
+  cerr << scenarios << " scenarios, " << threads << " threads" << endl;
+  return 0;
+}
@@ -83,7 +83,9 @@ double Position::dist(const Position& p) const
 Unit::Unit(int q, int w, const Position& p)
     : quantity(q),  // set quantity
       weight(w),    // set weight
-      pos(p)        // copy-construct pos from p
+      pos(p),       // copy-construct pos from p
+      owner(nullptr), // not in a list yet
+      lists(0)
 {
     // No additional logic in constructor body
 }
@@ -117,7 +119,13 @@ void Unit::scaleQuantity(double f)
     if (newScaled < 0) {
         newScaled = 0;
     }
+    int before = owner ? getAttackScore() : 0;
     quantity = newScaled;
+
+    // Keep the owning list's running totals in step
+    if (owner) {
+        owner->rescore(this, getAttackScore() - before);
+    }
 }
 
 // Scale weight by factor f, rounding up and clamping to non-negative
@@ -130,7 +138,13 @@ void Unit::scaleWeight(double f)
     if (newWeight < 0) {
         newWeight = 0;
     }
+    int before = owner ? getAttackScore() : 0;
     weight = newWeight;
+
+    // Keep the owning list's running totals in step
+    if (owner) {
+        owner->rescore(this, getAttackScore() - before);
+    }
 }
 
 
@@ -307,11 +321,13 @@ void Infantry::applyRule()
 
 
 UnitList::UnitList(int capacity)
-  : head(nullptr), tail(nullptr), vCnt(0), iCnt(0)
+  : typeMask(0u), vCnt(0), iCnt(0), vScore(0), iScore(0), shared(0)
 {
     cap = (capacity < 8) ? 12 : capacity;
+    for (int k = 0; k < TYPE_SLOTS; ++k) slot[k] = nullptr;
 }
 
+// Release every unit, so it can join another list afterwards
 UnitList::~UnitList() {
     clear();
 }
@@ -321,95 +337,47 @@ bool UnitList::append(Unit* u) {
 
     if (merge(u)) return true;
 
-    Node* node = createNode(u);
-    if (!tail) {
-        head = tail = node;
-    } else {
-        tail->next = node;
-        tail       = node;
-    }
-
-    u->isVehicle() ? ++vCnt : ++iCnt;
-
+    add(u, false);
     return true;
 }
 
 bool UnitList::insert(Unit* u) {
     if (!u) return false;
     if ((vCnt + iCnt) >= cap) return false;
-    if (pointerExists(u))     return false;
+    if (contains(u))          return false;
     if (merge(u))             return true;
 
-    Node* node = createNode(u);
-    if (u->isVehicle()) {
-        // append
-        if (!tail) {
-            head = tail = node;
-        } else {
-            tail->next = node;
-            tail       = node;
-        }
-        ++vCnt;
-    } else {
-        // prepend
-        node->next = head;
-        head       = node;
-        tail       = (tail ? tail : node);
-        ++iCnt;
-    }
+    // infantry prepend, vehicles append
+    add(u, !u->isVehicle());
     return true;
 }
 
 bool UnitList::isContain(VehicleType vt) const {
-    Node* cur = head;
-    if (cur) {
-        do {
-            if (cur->u->isVehicle() &&
-                static_cast<Vehicle*>(cur->u)->getType() == vt)
-            {
-                return true;
-            }
-            cur = cur->next;
-        } while (cur);
-    }
-    return false;
+    return (typeMask >> vt) & 1u;
 }
 
 bool UnitList::isContain(InfantryType it) const {
-    Node* cur = head;
-    if (cur) {
-        do {
-            if (!cur->u->isVehicle() &&
-                static_cast<Infantry*>(cur->u)->getType() == it)
-            {
-                return true;
-            }
-            cur = cur->next;
-        } while (cur);
-    }
-    return false;
+    return (typeMask >> (7 + it)) & 1u;
+}
+
+int UnitList::countOf(VehicleType vt) const {
+    return static_cast<int>((typeMask >> vt) & 1u);
 }
 
+int UnitList::countOf(InfantryType it) const {
+    return static_cast<int>((typeMask >> (7 + it)) & 1u);
+}
+
+// Unlink every dropped unit first, then close the gaps in one sweep
 void UnitList::remove(const std::vector<Unit*>& drop) {
-    std::size_t idx = 0;
-    std::size_t size = drop.size();
-    if (size > 0) {
-        do {
-            deleteFirstMatching(drop[idx]);
-            idx++;
-        } while (idx < size);
+    for (std::size_t idx = 0; idx < drop.size(); ++idx) {
+        unlink(drop[idx]);
     }
+    compact();
 }
 
 std::vector<Unit*> UnitList::extractAll() {
-    std::vector<Unit*> out;
-    Node* cur = head;
-    if (cur) {
-        do {
-            out.push_back(cur->u);
-            cur = cur->next;
-        } while (cur);
-    }
+    std::vector<Unit*> out = subset([](Unit*) { return true; });
     clear();
     return out;
 }
@@ -418,16 +386,14 @@ std::string UnitList::str() const {
     std::ostringstream oss;
     oss << "UnitList[count_vehicle=" << vCnt
         << ";count_infantry="        << iCnt;
-    if (head) {
+    if (vCnt + iCnt > 0) {
         oss << ";";
         bool first = true;
-        Node* cur = head;
-        do {
+        forEach([&](Unit* u) {
             if (!first) oss << ",";
             first = false;
-            oss << cur->u->str();
-            cur = cur->next;
-        } while (cur);
+            oss << u->str();
+        });
     }
     oss << "]";
     return oss.str();
@@ -435,76 +401,114 @@ std::string UnitList::str() const {
 
 // private helpers
 
-UnitList::Node* UnitList::createNode(Unit* u) {
-    Node* n = new Node{u, nullptr};
-    return n;
+// Slot of a unit's type: vehicles 0..6, infantry 7..12
+int UnitList::slotOf(const Unit* u) {
+    if (u->isVehicle()) {
+        return static_cast<const Vehicle*>(u)->getType();
+    }
+    return 7 + static_cast<const Infantry*>(u)->getType();
 }
 
-bool UnitList::pointerExists(Unit* u) const {
-    Node* cur = head;
-    if (cur) {
-        do {
-            if (cur->u == u) return true;
-            cur = cur->next;
-        } while (cur);
+void UnitList::add(Unit* u, bool atFront) {
+    atFront ? front.push_back(u) : back.push_back(u);
+    int k = slotOf(u);
+    slot[k] = u;
+    typeMask |= 1u << k;
+    u->isVehicle() ? ++vCnt : ++iCnt;
+    if (u->lists == 0) {
+        u->owner = this;
+        rescore(u, u->getAttackScore());
+    } else {
+        // Already in another list: nobody can follow its score any more
+        if (u->owner) {
+            u->owner->share(u);
+            u->owner = nullptr;
+        }
+        ++shared;
     }
-    return false;
+    ++u->lists;
 }
 
-void UnitList::deleteFirstMatching(Unit* target) {
-    Node* prev = nullptr;
-    Node* cur  = head;
-    while (cur) {
-        if (cur->u == target) {
-            Node* nxt = cur->next;
-            prev ? (prev->next = nxt) : (head = nxt);
-            tail = (cur == tail) ? prev : tail;
-            cur->u->isVehicle() ? --vCnt : --iCnt;
-            delete cur;
-            return;
+// Add delta to the running total of u's kind
+void UnitList::rescore(Unit* u, int delta) {
+    (u->isVehicle() ? vScore : iScore) += delta;
+}
+
+// A member this list held alone has been added to another list
+void UnitList::share(Unit* u) {
+    rescore(u, -u->getAttackScore());
+    ++shared;
+}
+
+// Current score of the shared members of one kind
+int UnitList::sharedScore(bool vehicles) const {
+    int sum = 0;
+    forEach([&](Unit* u) {
+        if (contains(u) && u->owner != this && u->isVehicle() == vehicles) {
+            sum += u->getAttackScore();
         }
-        prev = cur;
-        cur  = cur->next;
+    });
+    return sum;
+}
+
+int UnitList::vehicleScore() const {
+    return shared ? vScore + sharedScore(true) : vScore;
+}
+
+int UnitList::infantryScore() const {
+    return shared ? iScore + sharedScore(false) : iScore;
+}
+
+// Release a member's slot; the unit stays in its run until compact()
+void UnitList::unlink(Unit* target) {
+    if (!target || !contains(target)) return;
+    int k = slotOf(target);
+    slot[k] = nullptr;
+    typeMask &= ~(1u << k);
+    target->isVehicle() ? --vCnt : --iCnt;
+    if (target->owner == this) {
+        rescore(target, -target->getAttackScore());
+        target->owner = nullptr;
+    } else {
+        // The lists left holding it still count it as shared
+        --shared;
     }
+    --target->lists;
 }
 
-void UnitList::clear() {
-    Node* cur = head;
-    while (cur) {
-        Node* nxt = cur->next;
-        delete cur;
-        cur = nxt;
+// Drop the units that no longer own their slot, keeping the order
+void UnitList::compact() {
+    std::vector<Unit*>* parts[2] = { &front, &back };
+    for (int p = 0; p < 2; ++p) {
+        std::vector<Unit*>& part = *parts[p];
+        std::size_t kept = 0;
+        for (std::size_t k = 0; k < part.size(); ++k) {
+            if (contains(part[k])) {
+                part[kept++] = part[k];
+            }
+        }
+        part.resize(kept);
     }
-    head = tail = nullptr;
-    vCnt = iCnt = 0;
+}
+
+void UnitList::clear() {
+    forEach([this](Unit* u) {
+        unlink(u);
+    });
+    front.clear();
+    back.clear();
 }
 
 bool UnitList::merge(Unit* u) {
     if (!u) return false;
-    Node* cur = head;
-    if (cur) {
-        do {
-            if (cur->u->isVehicle() == u->isVehicle()) {
-                if (u->isVehicle()) {
-                    if (mergeVehicle(
-                          static_cast<Vehicle*>(cur->u),
-                          static_cast<Vehicle*>(u)))
-                    {
-                        return true;
-                    }
-                } else {
-                    if (mergeInfantry(
-                          static_cast<Infantry*>(cur->u),
-                          static_cast<Infantry*>(u)))
-                    {
-                        return true;
-                    }
-                }
-            }
-            cur = cur->next;
-        } while (cur);
+    Unit* existing = slot[slotOf(u)];
+    if (!existing) return false;
+    if (u->isVehicle()) {
+        return mergeVehicle(static_cast<Vehicle*>(existing),
+                            static_cast<Vehicle*>(u));
     }
-    return false;
+    return mergeInfantry(static_cast<Infantry*>(existing),
+                         static_cast<Infantry*>(u));
 }
 
 bool UnitList::mergeVehicle(Vehicle* existing, Vehicle* incoming) {
@@ -518,6 +522,7 @@ bool UnitList::mergeVehicle(Vehicle* existing, Vehicle* incoming) {
 bool UnitList::mergeInfantry(Infantry* existing, Infantry* incoming) {
     bool sameType = (existing->getType() == incoming->getType());
     if (!sameType) return false;
+    int before = existing->getAttackScore();
     existing->quantity += incoming->getQuantity();
     existing->weight = (incoming->weight > existing->weight)
                        ? incoming->weight
@@ -549,6 +554,9 @@ bool UnitList::mergeInfantry(Infantry* existing, Infantry* incoming) {
                              ? static_cast<int>(std::ceil(existing->quantity * 0.9))
                              : existing->quantity);
     existing->quantity = (existing->quantity < 0) ? 0 : existing->quantity;
+    if (existing->owner == this) {
+        rescore(existing, existing->getAttackScore() - before);
+    }
     return true;
 }
 
@@ -616,18 +624,23 @@ UnitList* Army::units() const
 
 void Army::update()
 {
-    // collect all units
+    // running totals kept by the unit list
+    int totalLF  = unitList->vehicleScore();
+    int totalEXP = unitList->infantryScore();
+
+#ifdef HCM_CHECK_SUMS
+    // debug builds: recompute from every unit and compare
     std::vector<Unit*> allUnits = unitList->subset(
         [](Unit* unitPointer) -> bool
         {
             return true;
         }
     );
-
-    int totalLF = 0;
-    int totalEXP = 0;
-
-    sumUnits(allUnits, static_cast<std::size_t>(0), totalLF, totalEXP);
+    int checkLF = 0;
+    int checkEXP = 0;
+    sumUnits(allUnits, static_cast<std::size_t>(0), checkLF, checkEXP);
+    assert(checkLF == totalLF && checkEXP == totalEXP);
+#endif
 
     setLF(totalLF);
     setEXP(totalEXP);
@@ -658,9 +671,73 @@ void Army::sumUnits(const std::vector<Unit*>& v,
     sumUnits(v, nextIndex, lf, ex);
 }
 
+// ------------------- UnitGrid Implementation -------------------
+
+namespace {
+    // Units of the army being processed by BattleField::apply; only the
+    // terrain effects in this file read it
+    thread_local const UnitGrid* _terrain_units = nullptr;
+}
+
+// Constructor: bucket the list's units by position (counting sort)
+UnitGrid::UnitGrid(const UnitList* list)
+    : minR(0), minC(0), side(1), rows(0), cols(0)
+{
+    // 1) Collect units and the bounding box of their positions
+    units = list->subset([](Unit*){ return true; });
+    std::size_t n = units.size();
+    if (n == 0) {
+        return;
+    }
+    minR = minC = INT_MAX;
+    int maxR = INT_MIN, maxC = INT_MIN;
+    for (std::size_t k = 0; k < n; ++k) {
+        Position p = units[k]->getPos();
+        minR = std::min(minR, p.getRow()); maxR = std::max(maxR, p.getRow());
+        minC = std::min(minC, p.getCol()); maxC = std::max(maxC, p.getCol());
+    }
+
+    // 2) Buckets of 4x4 cells, so a radius-5 query spans at most 4x4
+    //    buckets; wider ones if the units are spread thin, so there are
+    //    never many more buckets than units
+    long long spanR = (long long)maxR - minR + 1;
+    long long spanC = (long long)maxC - minC + 1;
+    side = 4;
+    while (((spanR + side - 1) / side) * ((spanC + side - 1) / side) > 2 * (long long)n + 64) {
+        side *= 2;
+    }
+    rows = (spanR + side - 1) / side;
+    cols = (spanC + side - 1) / side;
+
+    // 3) Count per bucket, prefix sums, then scatter
+    std::vector<std::size_t> bucketOf(n);
+    start.assign(static_cast<std::size_t>(rows * cols) + 1, 0);
+    for (std::size_t k = 0; k < n; ++k) {
+        Position p = units[k]->getPos();
+        long long br = ((long long)p.getRow() - minR) / side;
+        long long bc = ((long long)p.getCol() - minC) / side;
+        bucketOf[k] = static_cast<std::size_t>(br * cols + bc);
+        start[bucketOf[k] + 1]++;
+    }
+    for (std::size_t b = 0; b + 1 < start.size(); ++b) {
+        start[b + 1] += start[b];
+    }
+    std::vector<Unit*> sorted(n);
+    rowOf.resize(n);
+    colOf.resize(n);
+    std::vector<int> next(start.begin(), start.end() - 1);
+    for (std::size_t k = 0; k < n; ++k) {
+        int slot = next[bucketOf[k]]++;
+        sorted[slot] = units[k];
+        rowOf[slot] = units[k]->getPos().getRow();
+        colOf[slot] = units[k]->getPos().getCol();
+    }
+    units.swap(sorted);
+}
+
 // ------------------- BattleField Implementation -------------------
 
-// Constructor: build terrain elements and default roads
+// Constructor: build terrain elements; roads are left implicit
 BattleField::BattleField(int r, int c,
                          const std::vector<Position*>& f,
                          const std::vector<Position*>& rv,
@@ -669,20 +746,25 @@ BattleField::BattleField(int r, int c,
                          const std::vector<Position*>& sp)
     : R(r), C(c)
 {
-    // 1) Place each specified terrain type
-    addTerrains<Mountain>(f,  0);
-    addTerrains<River>(rv,    0);
-    addTerrains<Fortification>(fo, 0);
-    addTerrains<Urban>(ub,    0);
-    addTerrains<SpecialZone>(sp,   0);
+    // 0) Every cell starts out as a road; each is resolved in O(1)
+    std::size_t rows = (R > 0) ? static_cast<std::size_t>(R) : 0;
+    std::size_t cols = (C > 0) ? static_cast<std::size_t>(C) : 0;
+    Cell road = { ROAD_CELL, -1 };
+    cells.assign(rows * cols, road);
 
-    // 2) Fill any remaining grid cells with Road objects
-    fillRoads(0, 0);
+    // 1) Place each specified terrain type
+    addTerrains(f,  mountains,      MOUNTAIN_CELL);
+    addTerrains(rv, rivers,         RIVER_CELL);
+    addTerrains(fo, fortifications, FORTIFICATION_CELL);
+    addTerrains(ub, urbans,         URBAN_CELL);
+    addTerrains(sp, specialZones,   SPECIAL_ZONE_CELL);
 }
 
-// Destructor: delete all allocated TerrainElement pointers
+// Destructor: delete the Roads getElement allocated
 BattleField::~BattleField() {
-    deleteElems(0);
+    for (std::size_t idx = 0; idx < roads.size(); ++idx) {
+        delete roads[idx];
+    }
 }
 
 // Apply all terrain effects in sequence to the given army
@@ -690,8 +772,28 @@ void BattleField::apply(Army* a) {
     if (a == nullptr) {
         return;  // no army to affect
     }
+    // Unit positions do not change while terrain applies, so one index
+    // serves every element
+    UnitGrid grid(a->units());
     _terrain_applying = true;
-    applyRec(a, 0);
+    _terrain_units = &grid;
+    // Same order as the configuration lists; roads have no effect
+    for (std::size_t idx = 0; idx < mountains.size(); ++idx) {
+        mountains[idx].getEffect(a);
+    }
+    for (std::size_t idx = 0; idx < rivers.size(); ++idx) {
+        rivers[idx].getEffect(a);
+    }
+    for (std::size_t idx = 0; idx < fortifications.size(); ++idx) {
+        fortifications[idx].getEffect(a);
+    }
+    for (std::size_t idx = 0; idx < urbans.size(); ++idx) {
+        urbans[idx].getEffect(a);
+    }
+    for (std::size_t idx = 0; idx < specialZones.size(); ++idx) {
+        specialZones[idx].getEffect(a);
+    }
+    _terrain_units = nullptr;
     _terrain_applying = false;
 }
 
@@ -706,71 +808,60 @@ std::string BattleField::str() const {
 
 // Retrieve the terrain element at (row, col), or nullptr if none
 TerrainElement* BattleField::getElement(int row, int col) const {
-    return findElem(row, col, 0);
-}
-
-// Recursively scan grid and insert Road objects where no terrain exists
-void BattleField::fillRoads(int x, int y) {
-    if (x >= R) {
-        return; // reached beyond last row
-    }
-    if (y >= C) {
-        // end of column: wrap to next row
-        fillRoads(x + 1, 0);
-        return;
-    }
-    // If no terrain at this cell, create a Road
-    if (!terrainAt(x, y, 0)) {
-        Position pos(x, y);
-        Road* road = new Road(pos);
-        elems.push_back(road);
-    }
-    // Continue to next column
-    fillRoads(x, y + 1);
-}
-
-bool BattleField::terrainAt(int row, int col, std::size_t idx) const {
-    if (idx >= elems.size()) {
-        return false;  // no more elements to test
-    }
-    Position p = elems[idx]->getPos();
-    if (p.getRow() == row && p.getCol() == col) {
-        return true;
-    }
-    // Test next element
-    return terrainAt(row, col, idx + 1);
-}
-
-// Delete all terrain elements recursively
-void BattleField::deleteElems(std::size_t idx) {
-    if (idx >= elems.size()) {
-        return;  // done deleting
+    // Inside the grid: direct lookup in the cell index
+    if (row >= 0 && row < R && col >= 0 && col < C) {
+        Cell& cell = cells[static_cast<std::size_t>(row) * C + col];
+        if (cell.type != ROAD_CELL) {
+            return elementOf(cell);
+        }
+        // Make the cell's Road on first request and keep it, so the same
+        // cell always gives back the same element
+        if (cell.elem < 0) {
+            cell.elem = static_cast<int>(roads.size());
+            roads.push_back(new Road(Position(row, col)));
+        }
+        return roads[cell.elem];
+    }
+    // Outside: only terrain given with off-grid positions can match
+    for (std::size_t idx = 0; idx < offGrid.size(); ++idx) {
+        TerrainElement* e = elementOf(offGrid[idx]);
+        Position p = e->getPos();
+        if (p.getRow() == row && p.getCol() == col) {
+            return e;
+        }
     }
-    delete elems[idx];
-    deleteElems(idx + 1);
+    return nullptr;
 }
 
-
-// Recursively apply getEffect() of each terrain element to the army
-void BattleField::applyRec(Army* a, std::size_t idx) {
-    if (idx >= elems.size()) {
+// Record element id of the given type in its cell; the first element
+// placed on a cell is the one getElement returns
+void BattleField::placeElem(const Position& p, CellType type, int id) {
+    Cell entry = { type, id };
+    int row = p.getRow();
+    int col = p.getCol();
+    if (row < 0 || row >= R || col < 0 || col >= C) {
+        offGrid.push_back(entry);
         return;
     }
-    elems[idx]->getEffect(a);
-    applyRec(a, idx + 1);
+    Cell& cell = cells[static_cast<std::size_t>(row) * C + col];
+    if (cell.type == ROAD_CELL) {
+        cell = entry;
+    }
 }
 
-// Find and return the element at (row, col) or nullptr if not found
-TerrainElement* BattleField::findElem(int row, int col, std::size_t idx) const {
-    if (idx >= elems.size()) {
-        return nullptr;
+// Resolve a non-road cell to its element. Terrain is handed out mutable,
+// as it was when every element was allocated separately.
+TerrainElement* BattleField::elementOf(const Cell& cell) const {
+    const TerrainElement* e = nullptr;
+    switch (static_cast<CellType>(cell.type)) {
+    case MOUNTAIN_CELL:      e = &mountains[cell.elem];      break;
+    case RIVER_CELL:         e = &rivers[cell.elem];         break;
+    case FORTIFICATION_CELL: e = &fortifications[cell.elem]; break;
+    case URBAN_CELL:         e = &urbans[cell.elem];         break;
+    case SPECIAL_ZONE_CELL:  e = &specialZones[cell.elem];   break;
+    default:                 break;
     }
-    Position p = elems[idx]->getPos();
-    if (p.getRow() == row && p.getCol() == col) {
-        return elems[idx];
-    }
-    // Continue searching
-    return findElem(row, col, idx + 1);
+    return const_cast<TerrainElement*>(e);
 }
 
 using std::vector;
@@ -780,7 +871,7 @@ using std::ostringstream;
 
 // Primary constructor: builds a LiberationArmy with default name
 LiberationArmy::LiberationArmy(Unit** arr, int sz, BattleField* b)
-  : Army("LIBERATIONARMY"), bf(b)
+  : Army("LIBERATIONARMY"), bf(b), comboEps(0.0), comboBnd(1.0)
 {
     init(arr, sz);  // common initialization logic
 }
@@ -789,11 +880,21 @@ LiberationArmy::LiberationArmy(Unit** arr, int sz, BattleField* b)
 LiberationArmy::LiberationArmy(Unit** arr, int sz,
                                const std::string& name,
                                BattleField* b)
-  : Army(name), bf(b)
+  : Army(name), bf(b), comboEps(0.0), comboBnd(1.0)
 {
     init(arr, sz);
 }
 
+// Approximation allowed for the combos of later attacks
+void LiberationArmy::setComboEpsilon(double eps) {
+    comboEps = (eps > 0) ? eps : 0.0;
+}
+
+// Bound reported for the combos of the last attack
+double LiberationArmy::comboBound() const {
+    return comboBnd;
+}
+
 // Override to indicate this is the Liberation side
 bool LiberationArmy::isLiberation() const {
     return true;
@@ -875,43 +976,474 @@ std::string LiberationArmy::str() const {
     return formatStr("LiberationArmy");
 }
 
-// Find the minimal subset of units whose combined score >= need
+// ------------------- bestCombo solver -------------------
+
+namespace {
+
+// Most sums a SubsetSums table may span (its first[] alone takes 4 bytes
+// per sum); wider ranges go to SparseSums
+const long long COMBO_MAX_SUMS = 1LL << 24;
+
+// Most reachable sums a SparseSums table may hold, and most entries its
+// merges may visit in all; past either the bucketed pass takes over
+const std::size_t COMBO_MAX_SPARSE = std::size_t(1) << 21;
+const long long   COMBO_MAX_MERGE  = 1LL << 27;
+
+// Subset sums in [lo, hi] reachable from a sequence of items, added in
+// index order. Besides a bitset of the sums it records, for every sum,
+// the shortest prefix of items that reaches it; this is what lets
+// bestCombo rebuild the same subset its bitmask loop used to pick.
+class SubsetSums {
+public:
+    SubsetSums(long long lo, long long hi)
+        : lo(lo), hi(hi), zeroFirst(INT_MAX)
+    {
+        std::size_t size = static_cast<std::size_t>(hi - lo + 1);
+        bits.assign((size + 63) / 64, 0ULL);
+        moved.assign(bits.size(), 0ULL);
+        first.assign(size, INT_MAX);
+        // The empty subset reaches 0 with no items at all
+        bits[(0 - lo) / 64] |= 1ULL << ((0 - lo) % 64);
+        first[0 - lo] = 0;
+    }
+
+    // Add item `item` (0-based) with score v; sums leaving [lo, hi] are dropped
+    void add(int item, long long v) {
+        // A non-empty subset sums to 0 once v is 0, or an earlier subset
+        // sums to -v
+        if (zeroFirst == INT_MAX && (v == 0 || has(-v))) {
+            zeroFirst = item + 1;
+        }
+        if (v == 0) {
+            return;
+        }
+
+        // 1) moved = bits shifted by v
+        std::size_t W  = bits.size();
+        std::size_t ws = static_cast<std::size_t>((v > 0 ? v : -v) / 64);
+        int         bs = static_cast<int>((v > 0 ? v : -v) % 64);
+        for (std::size_t w = 0; w < W; ++w) {
+            unsigned long long x = 0;
+            if (v > 0 && w >= ws) {
+                x = bits[w - ws] << bs;
+                if (bs && w >= ws + 1) x |= bits[w - ws - 1] >> (64 - bs);
+            } else if (v < 0 && w + ws < W) {
+                x = bits[w + ws] >> bs;
+                if (bs && w + ws + 1 < W) x |= bits[w + ws + 1] << (64 - bs);
+            }
+            moved[w] = x;
+        }
+        std::size_t tail = first.size() % 64;
+        if (tail) moved[W - 1] &= (1ULL << tail) - 1;
+
+        // 2) Sums reached for the first time get this prefix length
+        for (std::size_t w = 0; w < W; ++w) {
+            unsigned long long fresh = moved[w] & ~bits[w];
+            while (fresh) {
+                first[w * 64 + __builtin_ctzll(fresh)] = item + 1;
+                fresh &= fresh - 1;
+            }
+            bits[w] |= moved[w];
+        }
+    }
+
+    // Shortest prefix reaching s with any subset (the empty one included),
+    // or INT_MAX
+    int firstReach(long long s) const {
+        return (s < lo || s > hi) ? INT_MAX : first[s - lo];
+    }
+
+    // Shortest prefix reaching s with a non-empty subset, or INT_MAX
+    int firstNonEmpty(long long s) const {
+        return (s == 0) ? zeroFirst : firstReach(s);
+    }
+
+    const long long lo, hi;
+
+private:
+    bool has(long long s) const {
+        return s >= lo && s <= hi &&
+               ((bits[(s - lo) / 64] >> ((s - lo) % 64)) & 1ULL);
+    }
+
+    std::vector<unsigned long long> bits;   // bit s-lo: s is reachable
+    std::vector<unsigned long long> moved;  // scratch for add()
+    std::vector<int> first;                 // first[s-lo], see firstReach
+    int zeroFirst;                          // see firstNonEmpty
+};
+
+// The same table for ranges too wide to span: only the reachable sums are
+// kept, sorted, each with the shortest prefix reaching it. It stays exact
+// but gives up once it outgrows COMBO_MAX_SPARSE or COMBO_MAX_MERGE.
+class SparseSums {
+public:
+    SparseSums(long long lo, long long hi)
+        : lo(lo), hi(hi), zeroFirst(INT_MAX), work(0)
+    {
+        sums.push_back(Entry{0, 0});  // the empty subset
+    }
+
+    // Add item `item` (0-based) with score v, as SubsetSums::add; false
+    // once the table has grown past its limits
+    bool add(int item, long long v) {
+        if (zeroFirst == INT_MAX && (v == 0 || firstReach(-v) != INT_MAX)) {
+            zeroFirst = item + 1;
+        }
+        if (v == 0) {
+            return true;
+        }
+
+        // Merge the sums with the sums shifted by v; a sum reached both
+        // ways keeps its earlier prefix
+        merged.clear();
+        std::size_t a = 0, b = 0, S = sums.size();
+        while (a < S || b < S) {
+            long long moved = (b < S) ? sums[b].sum + v : LLONG_MAX;
+            if (b < S && (moved < lo || moved > hi)) {
+                ++b;
+                continue;
+            }
+            if (a < S && sums[a].sum <= moved) {
+                if (sums[a].sum == moved) ++b;
+                merged.push_back(sums[a++]);
+            } else {
+                merged.push_back(Entry{moved, item + 1});
+                ++b;
+            }
+        }
+        work += static_cast<long long>(merged.size());
+        if (merged.size() > COMBO_MAX_SPARSE || work > COMBO_MAX_MERGE) {
+            return false;
+        }
+        sums.swap(merged);
+        return true;
+    }
+
+    // Least sum >= s reached by a non-empty subset, or LLONG_MAX
+    long long leastFrom(long long s) const {
+        for (std::size_t k = lowerBound(s); k < sums.size(); ++k) {
+            if (sums[k].sum != 0 || zeroFirst != INT_MAX) return sums[k].sum;
+        }
+        return LLONG_MAX;
+    }
+
+    // As SubsetSums::firstReach
+    int firstReach(long long s) const {
+        std::size_t k = lowerBound(s);
+        return (k < sums.size() && sums[k].sum == s) ? sums[k].first : INT_MAX;
+    }
+
+    // As SubsetSums::firstNonEmpty
+    int firstNonEmpty(long long s) const {
+        return (s == 0) ? zeroFirst : firstReach(s);
+    }
+
+    const long long lo, hi;
+
+private:
+    struct Entry {
+        long long sum;
+        int       first;
+    };
+
+    // Index of the first entry with a sum >= s
+    std::size_t lowerBound(long long s) const {
+        std::size_t l = 0, r = sums.size();
+        while (l < r) {
+            std::size_t mid = (l + r) / 2;
+            (sums[mid].sum < s) ? l = mid + 1 : r = mid;
+        }
+        return l;
+    }
+
+    std::vector<Entry> sums;    // reachable sums, ascending
+    std::vector<Entry> merged;  // scratch for add()
+    int zeroFirst;              // see firstNonEmpty
+    long long work;             // entries merged so far
+};
+
+// Rebuild the subset summing to best with the lowest bitmask from a table
+// of the units' subset sums; sets take[]
+template<typename Table>
+void rebuildCover(const Table& table, const vector<long long>& score,
+                  long long best, vector<bool>& take)
+{
+    // The lowest mask has the lowest top bit: the shortest prefix reaching
+    // best, minus one. Rebuild downward from there, leaving a unit out
+    // whenever the rest of the sum can still be made below it.
+    int top = table.firstNonEmpty(best) - 1;
+    take[top] = true;
+    long long rest = best - score[top];
+    for (int i = top - 1; i >= 0; --i) {
+        if (table.firstReach(rest) > i) {
+            take[i] = true;
+            rest -= score[i];
+        }
+    }
+}
+
+// Exact pass: least non-empty subset sum >= need among the units marked
+// inTable, or LLONG_MAX. Sets take[] to the subset with the lowest
+// bitmask over the unit indices.
+long long exactCover(const vector<long long>& score,
+                     const vector<bool>& inTable,
+                     long long need, long long lo, long long hi,
+                     vector<bool>& take)
+{
+    int n = static_cast<int>(score.size());
+    SubsetSums table(lo, hi);
+    for (int i = 0; i < n; ++i) {
+        if (inTable[i]) table.add(i, score[i]);
+    }
+
+    // 1) Least reachable sum >= need
+    long long best = LLONG_MAX;
+    for (long long s = std::max(need, lo); s <= hi; ++s) {
+        if (table.firstNonEmpty(s) != INT_MAX) {
+            best = s;
+            break;
+        }
+    }
+    if (best == LLONG_MAX) {
+        return best;
+    }
+
+    // 2) The subset with the lowest mask
+    rebuildCover(table, score, best, take);
+    return best;
+}
+
+// exactCover over sums in [lo, hi] too many to span; false when the
+// reachable ones are too many as well
+bool sparseCover(const vector<long long>& score,
+                 long long need, long long lo, long long hi,
+                 vector<bool>& take, long long& best)
+{
+    int n = static_cast<int>(score.size());
+    SparseSums table(lo, hi);
+    for (int i = 0; i < n; ++i) {
+        if (!table.add(i, score[i])) return false;
+    }
+    best = table.leastFrom(need);
+    if (best != LLONG_MAX) {
+        rebuildCover(table, score, best, take);
+    }
+    return true;
+}
+
+// Approximate pass for non-negative scores: sums are kept in buckets of
+// width K, each holding the largest true sum that landed in it. Every
+// unit added can lose less than K, so with m units in the table the
+// subset found overshoots the least sum by less than m*K. Returns its
+// sum, or LLONG_MAX, and sets take[].
+long long approxCover(const vector<long long>& score,
+                      const vector<bool>& inTable,
+                      long long need, long long hi, long long K,
+                      vector<bool>& take)
+{
+    // One step of a subset: its sum, the unit added and the step before
+    struct Step {
+        long long sum;
+        int       item;
+        int       prev;
+    };
+
+    int n = static_cast<int>(score.size());
+    long long m = 0;
+    for (int i = 0; i < n; ++i) {
+        if (inTable[i]) ++m;
+    }
+    long long cap = hi + m * K;  // no subset worth keeping lies above this
+    std::size_t B = static_cast<std::size_t>(cap / K) + 1;
+
+    vector<Step> steps(1, Step{0, -1, -1});  // the empty subset
+    vector<int>  bucket(B, -1);
+    bucket[0] = 0;
+
+    for (int i = 0; i < n; ++i) {
+        if (!inTable[i]) continue;
+        // Walk down so each bucket is read before this unit writes to it
+        for (std::size_t b = B; b-- > 0; ) {
+            if (bucket[b] < 0) continue;
+            long long sum = steps[bucket[b]].sum + score[i];
+            if (sum > cap) continue;
+            std::size_t nb = static_cast<std::size_t>(sum / K);
+            if (bucket[nb] < 0 || steps[bucket[nb]].sum < sum) {
+                steps.push_back(Step{sum, i, bucket[b]});
+                bucket[nb] = static_cast<int>(steps.size()) - 1;
+            }
+        }
+    }
+
+    // Least kept sum >= need: the bucket holding need if its sum reaches
+    // need, else the next bucket in use
+    std::size_t b = (need > 0) ? static_cast<std::size_t>(std::min(need / K, cap / K + 1)) : 0;
+    if (b < B && bucket[b] >= 0 && steps[bucket[b]].sum < need) {
+        ++b;
+    }
+    while (b < B && bucket[b] < 0) {
+        ++b;
+    }
+    if (b >= B) {
+        return LLONG_MAX;
+    }
+    for (int at = bucket[b]; steps[at].item >= 0; at = steps[at].prev) {
+        take[steps[at].item] = true;
+    }
+    return steps[bucket[b]].sum;
+}
+
+} // namespace
+
+// Find the minimal subset of units whose combined score >= need. Among
+// subsets with that sum, the one with the lowest bitmask over the unit
+// indices wins, as when every mask was tried in increasing order.
+//
+// With epsilon > 0 the sum may instead be up to (1 + epsilon) times the
+// least one, when that makes the search cheaper. So may it, whatever
+// epsilon, for negative scores with more reachable sums than the tables
+// can hold. If bound is given it receives the factor actually guaranteed
+// for the result: 1 only when the sum is the least, HUGE_VAL when there is
+// no factor, as for sums that are not positive.
 pair<int, vector<Unit*>> LiberationArmy::bestCombo(
-    const vector<Unit*>& units, int need)
+    const vector<Unit*>& units, int need, double epsilon, double* bound)
 {
+    if (bound) *bound = 1.0;
     int n = static_cast<int>(units.size());
     // If there are no units, return "no solution"
     if (n == 0) {
         return make_pair(INT_MAX, vector<Unit*>());
     }
 
-    int best = INT_MAX;
-    vector<Unit*> chosen;
-    int maxMask = 1 << n;  // total subsets
+    // 1) Score every unit once
+    vector<long long> score(n);
+    bool negative = false;
+    for (int i = 0; i < n; ++i) {
+        score[i] = units[i]->getAttackScore();
+        negative = negative || score[i] < 0;
+    }
+
+    // 2) Bound the sums worth tracking. With non-negative scores a unit
+    //    scoring >= need only wins on its own: any larger set holding it
+    //    sums at least as much and has a higher mask. The rest enter the
+    //    table, and a best sum from them is below need + their max score.
+    //    Negative scores can pull any sum back down, so all units enter;
+    //    only sums so low that every positive score together cannot lift
+    //    them back to need are dropped.
+    long long lo = 0, hi = 0;
+    long long negSum = 0;  // total of the negative scores
+    int single = -1;  // lowest-index unit with the least score >= need
+    long long m = 0;  // units in the table
+    vector<bool> inTable(n, negative);
+    if (negative) {
+        for (int i = 0; i < n; ++i) {
+            (score[i] < 0 ? negSum : hi) += score[i];
+        }
+        lo = std::min(0LL, std::max(negSum, need - hi));
+        m = n;
+    } else {
+        long long smallSum = 0, smallMax = 0;
+        for (int i = 0; i < n; ++i) {
+            if (score[i] >= need) {
+                if (single < 0 || score[i] < score[single]) single = i;
+            } else {
+                inTable[i] = true;
+                smallSum += score[i];
+                smallMax = std::max(smallMax, score[i]);
+                ++m;
+            }
+        }
+        if (need > 0 && smallSum >= need) {
+            hi = std::min(smallSum, need + smallMax - 1);
+        }
+    }
 
-    int mask = 1;
-    if (maxMask > 1) do {
-        int sum = 0;
-        vector<Unit*> tmp;
-        int idx4 = 0;
-        // Iterate bits of mask
-        if (n > 0) do {
-            if (mask & (1 << idx4)) {
-                sum += units[idx4]->getAttackScore();
-                tmp.push_back(units[idx4]);
+    // 3) Search the table. Buckets of width K = epsilon*need/m keep the
+    //    overshoot within epsilon*need; they are used only when fewer
+    //    than the exact pass's bitset words. With negative scores a range
+    //    too wide for the exact table keeps only the reachable sums, and
+    //    when even those are too many forces buckets wide enough to fit,
+    //    whatever epsilon; without them the range is already within need.
+    vector<bool> take(n, false);
+    long long best;
+    long long floorBest;  // proven lower bound on the least table sum
+    long long K = (epsilon > 0 && !negative && m > 0)
+                  ? static_cast<long long>(epsilon * need / m) : 0;
+    bool fits = !negative || hi - lo < COMBO_MAX_SUMS;
+    if (!fits && sparseCover(score, need, lo, hi, take, best)) {
+        floorBest = best;
+    } else if (!fits) {
+        take.assign(n, false);
+        // Bucketed sums start at 0, and each of the m units may add a step
+        // per bucket
+        K = std::max(K, (hi - negSum) * m / COMBO_MAX_SUMS + 1);
+        // Count each negative score as its absolute value, taken when the
+        // unit is left out: sums shift up by -negSum and are non-negative
+        vector<long long> mag(n);
+        for (int i = 0; i < n; ++i) {
+            mag[i] = (score[i] < 0) ? -score[i] : score[i];
+        }
+        best = approxCover(mag, inTable, need - negSum, hi - negSum, K, take);
+        bool any = false;
+        if (best != LLONG_MAX) {
+            for (int i = 0; i < n; ++i) {
+                if (score[i] < 0) take[i] = !take[i];
+                any = any || take[i];
+            }
+        }
+        // Leaving every unit out is no combo. It only wins when need <= 0,
+        // and then the least single score that reaches need stands in.
+        if (any) {
+            best += negSum;
+        } else {
+            if (best != LLONG_MAX) {
+                for (int i = 0; i < n; ++i) {
+                    if (score[i] >= need && (single < 0 || score[i] < score[single])) single = i;
+                }
             }
-            idx4++;
-        } while (idx4 < n);
+            best = LLONG_MAX;
+            take.assign(n, false);
+        }
+        floorBest = std::max<long long>(need, best - m * K + 1);
+    } else if (K > 1 && (hi + m * K) / K < (hi + 1) / 64) {
+        best = approxCover(score, inTable, need, hi, K, take);
+        floorBest = std::max<long long>(need, best - m * K + 1);
+    } else {
+        best = exactCover(score, inTable, need, lo, hi, take);
+        floorBest = best;
+    }
 
-        // If this subset is a new best, remember it
-        if (sum >= need && sum < best) {
-            best = sum;
-            chosen = tmp;
+    // 4) Compare with the single unit; on equal sums the lower mask wins
+    int top = n - 1;
+    while (top >= 0 && !take[top]) --top;
+    if (single >= 0 &&
+        (top < 0 || score[single] < best ||
+         (score[single] == best && single < top)))
+    {
+        if (bound && negative) {
+            *bound = HUGE_VAL;  // only the fallback above, with need <= 0
+        } else if (bound && top >= 0 && floorBest < score[single]) {
+            *bound = static_cast<double>(score[single]) / floorBest;
         }
-        mask++;
-    } while (mask < maxMask);
+        return make_pair(static_cast<int>(score[single]),
+                         vector<Unit*>(1, units[single]));
+    }
+    if (top < 0) {
+        return make_pair(INT_MAX, vector<Unit*>());
+    }
+    if (bound) {
+        long long floorAll = (single >= 0)
+                             ? std::min(floorBest, score[single]) : floorBest;
+        // A ratio means nothing once the floor is not positive
+        *bound = (floorAll > 0) ? static_cast<double>(best) / floorAll
+               : (best == floorAll) ? 1.0 : HUGE_VAL;
+    }
 
-    return make_pair(best, chosen);
+    vector<Unit*> chosen;
+    for (int i = 0; i < n; ++i) {
+        if (take[i]) chosen.push_back(units[i]);
+    }
+    return make_pair(static_cast<int>(best), chosen);
 }
 
 
@@ -1000,7 +1532,7 @@ void ARVN::init(Unit** arr, int sz) {
 
 // Helper to check application guard
 static inline bool shouldApply(Army* a) {
-    return _terrain_applying && a;
+    return _terrain_applying && _terrain_units && a;
 }
 
 // Lookup tables for terrain parameters
@@ -1017,54 +1549,40 @@ static int fibUp(int x) {
 }
 
 inline void Mountain::getEffect(Army* a) {
-    if (!_terrain_applying || !a) return;
+    if (!shouldApply(a)) return;
 
     bool isLib = a->isLiberation();
     // Inline radius and percentages rather than from a map
-    double radius = isLib ? 2.0 : 4.0;
+    int radius = isLib ? 2 : 4;
     double vehPct  = isLib ? 0.10 : 0.05;
     double infPct  = isLib ? 0.30 : 0.20;
 
-    // Collect units and iterate with do-while
-    std::vector<Unit*> units = a->units()->subset([](Unit* u){ return true; });
-if (!units.empty()) {
-    std::size_t idx = 0;
-    do {
-        Unit* u = units[idx];
-        double dist = u->getPos().dist(pos);
-        if (u->isVehicle() && dist <= radius) {
+    // Only the units within radius, found through the grid index
+    _terrain_units->forEachNear(pos, radius, [&](Unit* u, long long) {
+        if (u->isVehicle()) {
             u->scaleWeight(1.0 - vehPct);
-        } else if (!u->isVehicle() && dist <= radius) {
+        } else {
             u->scaleWeight(1.0 + infPct);
         }
-        idx++;
-    } while (idx < units.size());
-}
+    });
 
     a->update();
 }
 
 inline void River::getEffect(Army* a) {
     if (!shouldApply(a)) return;
-    double radius = 2.0;
+    int radius = 2;
     int beforeLF = a->getLF();
     int beforeEXP = a->getEXP();
     int dLF = 0;
     int dEXP = 0;
 
-    std::vector<Unit*> units = a->units()->subset([](Unit* u){ return !u->isVehicle(); });
-if (!units.empty()) {
-    std::size_t idx = 0;
-    do {
-        Unit* u = units[idx];
-        double dist = u->getPos().dist(pos);
-        if (dist <= radius) {
+    _terrain_units->forEachNear(pos, radius, [&](Unit* u, long long) {
+        if (!u->isVehicle()) {
             int sc = u->getAttackScore();
             dEXP -= static_cast<int>(sc * 0.10);
         }
-        idx++;
-    } while (idx < units.size());
-}
+    });
     a->setLF(beforeLF + dLF);
     a->setEXP(beforeEXP + dEXP);
 }
@@ -1072,40 +1590,35 @@ if (!units.empty()) {
 inline void Urban::getEffect(Army* a) {
     if (!shouldApply(a)) return;
     bool isLib = a->isLiberation();
-    double radius = isLib ? 5.0 : 3.0;  // was p[0] or p[1]
-    double artRad  = 2.0;               // was p[2]
+    int radius = isLib ? 5 : 3;  // was p[0] or p[1]
+    int artRad  = 2;             // was p[2]
 
     int beforeLF = a->getLF();
     int beforeEXP = a->getEXP();
     int dLF = 0;
     int dEXP = 0;
 
-    std::vector<Unit*> units = a->units()->subset([](Unit* u){ return true; });
-if (!units.empty()) {
-    std::size_t idx = 0;
-    do {
-        Unit* u = units[idx];
-        double dist = u->getPos().dist(pos);
-        if (!u->isVehicle() && dist <= radius) {
+    // Both radii are within `radius`; d2 is the squared distance
+    _terrain_units->forEachNear(pos, radius, [&](Unit* u, long long d2) {
+        if (!u->isVehicle()) {
             Infantry* inf = static_cast<Infantry*>(u);
             InfantryType t = inf->getType();
             bool ok = (isLib ? (t==SPECIALFORCES||t==REGULARINFANTRY) : (t==REGULARINFANTRY));
             if (ok) {
                 int sc = u->getAttackScore();
                 double factor = (isLib ? 2.0 : 1.5);
+                double dist = u->getPos().dist(pos);
                 dEXP += static_cast<int>(std::ceil(factor * sc / dist));
             }
         }
-        if (isLib && u->isVehicle() && dist <= artRad) {
+        if (isLib && u->isVehicle() && d2 <= (long long)artRad * artRad) {
             Vehicle* v = static_cast<Vehicle*>(u);
             if (v->getType() == ARTILLERY) {
                 int sc = u->getAttackScore();
                 dLF -= static_cast<int>(std::ceil(0.5 * sc));
             }
         }
-        idx++;
-    } while (idx < units.size());
-}
+    });
     a->setLF(beforeLF + dLF);
     a->setEXP(beforeEXP + dEXP);
 }
@@ -1113,56 +1626,38 @@ if (!units.empty()) {
 inline void Fortification::getEffect(Army* a) {
     if (!shouldApply(a)) return;
     bool isLib = a->isLiberation();
-  double radius = 2.0;    // was terrainParams.at("Fortification")[0]
+  int    radius = 2;      // was terrainParams.at("Fortification")[0]
   double pct    = 0.20;   // was terrainParams.at("Fortification")[1]
 
     int beforeLF = a->getLF();
     int beforeEXP = a->getEXP();
     int dLF=0, dEXP=0;
 
-    std::vector<Unit*> units = a->units()->subset([](Unit* u){ return true; });
-if (!units.empty()) {
-    std::size_t idx = 0;
-    do {
-        Unit* u = units[idx];
-        double dist = u->getPos().dist(pos);
-        if (dist <= radius) {
-            int sc = u->getAttackScore();
-            int amt = static_cast<int>(sc * pct);
-            if (isLib == u->isVehicle()) dLF -= amt;
-            else if (!isLib && !u->isVehicle()) dEXP += amt;
-            else if (!isLib && u->isVehicle()) dLF += amt;
-            else dEXP -= amt;
-        }
-        idx++;
-    } while (idx < units.size());
-}
+    _terrain_units->forEachNear(pos, radius, [&](Unit* u, long long) {
+        int sc = u->getAttackScore();
+        int amt = static_cast<int>(sc * pct);
+        if (isLib == u->isVehicle()) dLF -= amt;
+        else if (!isLib && !u->isVehicle()) dEXP += amt;
+        else if (!isLib && u->isVehicle()) dLF += amt;
+        else dEXP -= amt;
+    });
     a->setLF(beforeLF + dLF);
     a->setEXP(beforeEXP + dEXP);
 }
 
 inline void SpecialZone::getEffect(Army* a) {
     if (!shouldApply(a)) return;
-  double radius = 1.0;    // was terrainParams.at("SpecialZone")[0]
+  int radius = 1;         // was terrainParams.at("SpecialZone")[0]
 
     int beforeLF  = a->getLF();
     int beforeEXP = a->getEXP();
     int dLF=0, dEXP=0;
 
-    std::vector<Unit*> units = a->units()->subset([](Unit* u){ return true; });
-if (!units.empty()) {
-    std::size_t idx = 0;
-    do {
-        Unit* u = units[idx];
-        double dist = u->getPos().dist(pos);
-        if (dist <= radius) {
-            int sc = u->getAttackScore();
-            if (u->isVehicle()) dLF -= sc;
-            else dEXP -= sc;
-        }
-        idx++;
-    } while (idx < units.size());
-}
+    _terrain_units->forEachNear(pos, radius, [&](Unit* u, long long) {
+        int sc = u->getAttackScore();
+        if (u->isVehicle()) dLF -= sc;
+        else dEXP -= sc;
+    });
     a->setLF(beforeLF + dLF);
     a->setEXP(beforeEXP + dEXP);
 }
@@ -1233,10 +1728,12 @@ inline void LiberationArmy::fight(Army* enemy, bool defense) {
     std::vector<Unit*> vehUnits = unitList->subset([](Unit* u){ return u->isVehicle(); });
 
     // 5b. Determine best combinations
-    std::pair<int,std::vector<Unit*>> comboIPair = bestCombo(infUnits, enemy->getEXP());
+    double boundI = 1.0, boundV = 1.0;
+    std::pair<int,std::vector<Unit*>> comboIPair = bestCombo(infUnits, enemy->getEXP(), comboEps, &boundI);
     std::vector<Unit*> comboI = comboIPair.second;
-    std::pair<int,std::vector<Unit*>> comboVPair = bestCombo(vehUnits, enemy->getLF());
+    std::pair<int,std::vector<Unit*>> comboVPair = bestCombo(vehUnits, enemy->getLF(), comboEps, &boundV);
     std::vector<Unit*> comboV = comboVPair.second;
+    comboBnd = std::max(boundI, boundV);
 
     bool gotI = !comboI.empty();
     bool gotV = !comboV.empty();
@@ -1289,12 +1786,10 @@ inline void LiberationArmy::fight(Army* enemy, bool defense) {
 
     // 5f. Partial cleanup
     if (gotI && !gotV) {
-        std::vector<Unit*> dropV = unitList->subset([](Unit* u){ return u->isVehicle(); });
-        unitList->remove(dropV);
+        unitList->removeIf([](Unit* u){ return u->isVehicle(); });
     }
     if (!gotI && gotV) {
-        std::vector<Unit*> dropI = unitList->subset([](Unit* u){ return !u->isVehicle(); });
-        unitList->remove(dropI);
+        unitList->removeIf([](Unit* u){ return !u->isVehicle(); });
     }
 
     // 5g. Confiscate enemy units in reverse order
@@ -1332,8 +1827,7 @@ inline void ARVN::fight(Army* enemy, bool defense) {
         }
 
         // Remove any units with quantity ≤ 1
-        auto drop = unitList->subset([](Unit* u){ return u->getQuantity() <= 1; });
-        unitList->remove(drop);
+        unitList->removeIf([](Unit* u){ return u->getQuantity() <= 1; });
 
         update();
         return;
@@ -1716,16 +2210,10 @@ void Configuration::parseFile(const std::string& path) {
 
 // Helper: Purge units with attackScore <= threshold from an army
 static void purgeArmy(Army* army, int threshold) {
-    // Collect pointers to remove
-    std::vector<Unit*> toRemove;
-    // Use forEach to iterate units; lambda remains since no for-loop here
-    army->units()->forEach([&](Unit* u) {
-        if (u->getAttackScore() <= threshold) {
-            toRemove.push_back(u);
-        }
+    // Remove weak units in a single pass and update indices
+    army->units()->removeIf([&](Unit* u) {
+        return u->getAttackScore() <= threshold;
     });
-    // Remove collected units and update indices
-    army->units()->remove(toRemove);
     army->update();
 }
 
@@ -1777,10 +2265,16 @@ HCMCampaign::HCMCampaign(const std::string& path) {
 
 // Destructor: release all allocated resources
 HCMCampaign::~HCMCampaign() {
-    delete cfg;
-    delete bf;
+    // The armies release their units, which cfg owns, so they go first
     delete lib;
     delete arvn;
+    delete cfg;
+    delete bf;
+}
+
+// Forward the combo tolerance to the Liberation Army
+void HCMCampaign::setComboEpsilon(double eps) {
+    lib->setComboEpsilon(eps);
 }
 
 // Run the full simulation: terrain then battle, followed by purging
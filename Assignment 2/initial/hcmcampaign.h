@@ -30,6 +30,7 @@ namespace {
 // Forward declarations for all core types
 class Unit;
 class UnitList;
+class UnitGrid;
 class Army;
 class TerrainElement;
 class Vehicle;
@@ -98,6 +99,11 @@ protected:
     int      weight;    // power weight
     Position pos;       // map location
 
+private:
+    UnitList* owner;    // sole list holding the unit, told when its score
+                        // changes; nullptr when shared or in no list
+    int       lists;    // number of lists holding the unit
+
 public:
     Unit(int q, int w, const Position& p);
     virtual ~Unit();
@@ -151,22 +157,42 @@ private:
 
 
 /*------------------------------------------------ UnitList ---------*/
-/// Singly‐linked list of Unit* with merge/insert/remove logic.
+/// Contiguous list of Unit* with merge/insert/remove logic.
 class UnitList {
+    friend class Unit;
+
 private:
-    struct Node {
-        Unit* u;
-        Node* next;
-    };
+    // One slot per unit type: vehicle types first, then infantry types
+    static const int TYPE_SLOTS = 13;
 
-    Node* head;
-    Node* tail;
-    int   vCnt;   // number of vehicle nodes
-    int   iCnt;   // number of infantry nodes
+    // The list reads as front backwards, then back forwards: prepended
+    // units are pushed onto front, appended units onto back.
+    std::vector<Unit*> front;
+    std::vector<Unit*> back;
+
+    // The unit of each type held by the list, or nullptr. A unit merges
+    // into the one of its type already present, so there is never more
+    // than one and this doubles as the membership index.
+    Unit* slot[TYPE_SLOTS];
+
+    // Bit k set iff slot[k] is occupied
+    unsigned typeMask;
+
+    int   vCnt;   // number of vehicles
+    int   iCnt;   // number of infantry
     int   cap;    // maximum capacity
 
+    // Running attack-score totals over the units only this list holds,
+    // which report their score changes to it. Units shared with another
+    // list report to none, so their scores are summed afresh each time.
+    int   vScore; // sum over vehicles
+    int   iScore; // sum over infantry
+    int   shared; // number of members shared with another list
+
 public:
     explicit UnitList(int capacity);
+
+    // Releases the units, which must still be alive
     ~UnitList();
 
     // Always merges if possible, else appends
@@ -179,40 +205,67 @@ public:
     bool isContain(VehicleType vt)   const;
     bool isContain(InfantryType it)  const;
 
+    // Number of units of a type (0 or 1, since same types merge)
+    int countOf(VehicleType vt)  const;
+    int countOf(InfantryType it) const;
+
     // Iterate all units with a lambda
     template<typename Func>
     void forEach(Func f) const {
-        for (Node* cur = head; cur; cur = cur->next)
-            f(cur->u);
+        for (std::size_t k = front.size(); k > 0; --k)
+            f(front[k - 1]);
+        for (std::size_t k = 0; k < back.size(); ++k)
+            f(back[k]);
     }
 
     // Return all units matching predicate
     template<typename Pred>
     std::vector<Unit*> subset(Pred pred) const {
         std::vector<Unit*> out;
-        for (Node* cur = head; cur; cur = cur->next)
-            if (pred(cur->u))
-                out.push_back(cur->u);
+        out.reserve(front.size() + back.size());
+        forEach([&](Unit* u) {
+            if (pred(u))
+                out.push_back(u);
+        });
         return out;
     }
 
     // Remove specific pointers
     void remove(const std::vector<Unit*>& drop);
 
+    // Remove every unit matching predicate, in one pass
+    template<typename Pred>
+    void removeIf(Pred pred) {
+        forEach([&](Unit* u) {
+            if (pred(u))
+                unlink(u);
+        });
+        compact();
+    }
+
     // Extract all pointers, clearing the list
     std::vector<Unit*> extractAll();
 
     int vehicles()   const { return vCnt; }
     int infantries() const { return iCnt; }
 
+    // Total attack score of the vehicles / of the infantry
+    int vehicleScore()  const;
+    int infantryScore() const;
+
     // Serialize list to string
     std::string str() const;
 
 private:
-    // Internal node management and merge routines
-    Node* createNode(Unit* u);
-    bool  pointerExists(Unit* u) const;
-    void  deleteFirstMatching(Unit* target);
+    // Slot table helpers and merge routines
+    static int slotOf(const Unit* u);
+    bool  contains(Unit* u) const { return slot[slotOf(u)] == u; }
+    void  add(Unit* u, bool atFront);
+    void  rescore(Unit* u, int delta);
+    void  share(Unit* u);
+    int   sharedScore(bool vehicles) const;
+    void  unlink(Unit* target);
+    void  compact();
     void  clear();
     bool  merge(Unit* u);
     bool  mergeVehicle(  Vehicle*  existing, Vehicle*  incoming);
@@ -220,6 +273,54 @@ private:
 };
 
 
+/*------------------------------------------------ UnitGrid ---------*/
+/// Uniform-grid index over the positions of a list's units, so that a
+/// terrain element only visits the units inside its radius.
+class UnitGrid {
+public:
+    explicit UnitGrid(const UnitList* list);
+
+    // Calls f(u, d2) for every unit whose squared distance d2 to p is at
+    // most radius*radius, one bucket at a time
+    template<typename Func>
+    void forEachNear(const Position& p, int radius, Func f) const {
+        if (units.empty()) return;
+
+        // Bucket range overlapping the square around p
+        long long rowLo = (long long)p.getRow() - radius - minR;
+        long long rowHi = (long long)p.getRow() + radius - minR;
+        long long colLo = (long long)p.getCol() - radius - minC;
+        long long colHi = (long long)p.getCol() + radius - minC;
+        if (rowHi < 0 || colHi < 0) return;
+        long long br0 = (rowLo < 0) ? 0 : rowLo / side;
+        long long bc0 = (colLo < 0) ? 0 : colLo / side;
+        long long br1 = std::min<long long>(rows - 1, rowHi / side);
+        long long bc1 = std::min<long long>(cols - 1, colHi / side);
+
+        long long limit = (long long)radius * radius;
+        for (long long br = br0; br <= br1; ++br) {
+            for (long long bc = bc0; bc <= bc1; ++bc) {
+                std::size_t b = static_cast<std::size_t>(br * cols + bc);
+                for (int k = start[b]; k < start[b + 1]; ++k) {
+                    long long dr = (long long)rowOf[k] - p.getRow();
+                    long long dc = (long long)colOf[k] - p.getCol();
+                    long long d2 = dr * dr + dc * dc;
+                    if (d2 <= limit) f(units[k], d2);
+                }
+            }
+        }
+    }
+
+private:
+    int minR, minC;              // smallest unit row/col
+    long long side;              // bucket side, in map cells
+    long long rows, cols;        // buckets per column/row of the grid
+    std::vector<int>   start;    // units of bucket b: [start[b], start[b+1])
+    std::vector<Unit*> units;    // grouped by bucket
+    std::vector<int>   rowOf, colOf;
+};
+
+
 /*------------------------------------------------ Terrain ----------*/
 /// Base for map terrain elements that modify an Army.
 class TerrainElement {
@@ -264,7 +365,8 @@ public:
     // Access underlying units
     UnitList* units() const;
 
-    // Recompute LF/EXP from the units
+    // Set LF/EXP from the unit list's running totals. Building with
+    // HCM_CHECK_SUMS defined checks them against a full recomputation.
     void update();
 
     // Battle must be defined by subclasses
@@ -273,7 +375,7 @@ public:
     virtual std::string str()                    const = 0;
 
 private:
-    // Recursive helper for update()
+    // Recursive helper for the HCM_CHECK_SUMS check in update()
     void sumUnits(const std::vector<Unit*>& v, std::size_t idx, int& lf, int& ex);
 };
 
@@ -281,7 +383,32 @@ private:
 class BattleField {
 private:
     int R, C;  // rows, cols
-    std::vector<TerrainElement*> elems;
+
+    // Kind of terrain held by a grid cell
+    enum CellType : unsigned char {
+        ROAD_CELL, MOUNTAIN_CELL, RIVER_CELL,
+        FORTIFICATION_CELL, URBAN_CELL, SPECIAL_ZONE_CELL
+    };
+
+    // One grid cell, packed into 4 bytes: the type and the index of the
+    // first element placed there in that type's array. Cells nobody placed
+    // terrain on are roads; their elem indexes roads once getElement has
+    // made the Road, and is -1 until then.
+    struct Cell {
+        unsigned type : 3;   // CellType
+        int      elem : 29;
+    };
+
+    // Only non-road terrain is stored, by value, one array per type
+    std::vector<Mountain>      mountains;
+    std::vector<River>         rivers;
+    std::vector<Fortification> fortifications;
+    std::vector<Urban>         urbans;
+    std::vector<SpecialZone>   specialZones;
+
+    mutable std::vector<Cell>  cells;    // R*C cells, row-major
+    mutable std::vector<Road*> roads;    // Roads handed out by getElement
+    std::vector<Cell>          offGrid;  // elements outside the grid
 
 public:
     BattleField(int r, int c,
@@ -298,18 +425,15 @@ public:
     // "(n_rows,n_cols)"
     std::string str() const;
 
-    // Query element at (r,c), or nullptr
+    // Query element at (r,c), or nullptr; uncovered grid cells give a Road
     TerrainElement* getElement(int row, int col) const;
 
 private:
-    // Recursively add each type, fill with Roads, etc.
+    // Copy each position of one type into its array and index it
     template<typename T>
-    void addTerrains(const std::vector<Position*>& v, std::size_t idx);
-    void fillRoads(int x, int y);
-    bool terrainAt(int row, int col, std::size_t idx) const;
-    void deleteElems(std::size_t idx);
-    void applyRec(Army* a, std::size_t idx);
-    TerrainElement* findElem(int row, int col, std::size_t idx) const;
+    void addTerrains(const std::vector<Position*>& v, std::vector<T>& dst, CellType type);
+    void placeElem(const Position& p, CellType type, int id);
+    TerrainElement* elementOf(const Cell& cell) const;
 };
 
 
@@ -324,12 +448,22 @@ public:
     void        fight(Army* enemy, bool defense = false) override;
     std::string str()               const override;
 
+    // Combos chosen by later fights may sum up to (1 + eps) times the
+    // least sum; 0 (the default) keeps them exact
+    void   setComboEpsilon(double eps);
+    // Guaranteed factor for the combos of the last attack (1 if exact,
+    // HUGE_VAL if none)
+    double comboBound() const;
+
 private:
     BattleField* bf;
+    double       comboEps;    // see setComboEpsilon
+    double       comboBnd;    // see comboBound
 
     void init(Unit** arr, int sz);  // shared constructor logic
     std::string formatStr(const std::string& label) const;
-    static std::pair<int,std::vector<Unit*>> bestCombo(const std::vector<Unit*>& units, int need);
+    static std::pair<int,std::vector<Unit*>> bestCombo(const std::vector<Unit*>& units, int need,
+                                                       double epsilon = 0.0, double* bound = nullptr);
 };
 
 /// ARVN: fixed combat indices, desertion/weight penalties
@@ -423,15 +557,20 @@ public:
     // Apply terrain, execute fight(s), then purge low‐score units
     void        run();
 
+    // eps > 0 lets the Liberation Army pick approximate combos in run()
+    void        setComboEpsilon(double eps);
+
     // "LIBERATIONARMY[LF=...,EXP=...]-ARVN[LF=...,EXP=...]"
     std::string printResult() const;
 };
 // In hcmcampaign.h, after class BattleField { … };
 template<typename T>
-void BattleField::addTerrains(const std::vector<Position*>& v, std::size_t idx) {
-    if (idx >= v.size()) return;
-    elems.push_back(new T(*v[idx]));
-    addTerrains<T>(v, idx + 1);
+void BattleField::addTerrains(const std::vector<Position*>& v, std::vector<T>& dst, CellType type) {
+    dst.reserve(v.size());
+    for (std::size_t idx = 0; idx < v.size(); ++idx) {
+        dst.push_back(T(*v[idx]));
+        placeElem(*v[idx], type, static_cast<int>(dst.size() - 1));
+    }
 }
 // In hcmcampaign.h, after class Configuration { … };
 template<typename T>